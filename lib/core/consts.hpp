@@ -8,7 +8,105 @@ namespace core {
 // define value for infinity
 const int kIntInfinity = std::numeric_limits<int>::max();
 const double kFloatInfinity = std::numeric_limits<double>::max();
+// explicit infinity for the presolve bounds, kept apart from any finite value
+const double kInfinity = std::numeric_limits<double>::infinity();
 const float kEpsilon = 1e-14;
 const int kMaxIterations = 1000;
 
+// tolerances for solvers working in double precision
+const double kFeasibilityTolerance = 1e-7;
+const double kPivotTolerance = 1e-9;
+const double kPerturbation = 1e-6;
+
+// smallest relative improvement for presolve to accept a propagated bound,
+// stops propagation creeping towards a limit
+const double kBoundImprovementTolerance = 1e-3;
+
+// largest magnitude up to which a double holds every integer exactly, presolve
+// gives up rather than carry on with integer bounds past it
+const double kMaxExactInteger = 9007199254740992.0;
+
+// branch and bound: default limit on the nodes explored, and how far a value
+// may be from an integer and still be rounded to it
+const int kMaxBranchAndBoundNodes = 1000;
+const double kIntegralityTolerance = 1e-6;
+
+// largest problems solved by a fixed size dual simplex, every size up to these
+// gets its own instantiation
+const int kTinySimplexMaxRows = 8;
+const int kTinySimplexMaxColumns = 3;
+
+// fourier-motzkin elimination: most inequalities held before giving up, most
+// columns of a problem it is tried on, and largest denominator a fractional
+// bound is scaled by to make it an integer
+const int kFourierMotzkinMaxRows = 256;
+const int kFourierMotzkinMaxColumns = 4;
+const double kFourierMotzkinMaxDenominator = 1000;
+
+// interior point method: fewest variables of a problem sent to it, iteration
+// limit, tolerance on residuals and complementarity, and fraction of the step
+// to the boundary taken
+const int kInteriorPointMinVariables = 16;
+const int kInteriorPointMaxIterations = 100;
+const double kInteriorPointTolerance = 1e-9;
+const double kInteriorPointStepFraction = 0.99;
+
+// sparse cholesky: pivots below this fraction of the largest diagonal are
+// replaced by the huge pivot
+const double kCholeskyPivotTolerance = 1e-30;
+const double kCholeskyHugePivot = 1e64;
+
+// primal-dual hybrid gradient: fewest variables of a problem sent to it,
+// iteration limit, iterations between checks for a verdict or restart,
+// tolerance on the Farkas ray, and number of scaling passes
+const int kPdhgMinVariables = 1000;
+const int kPdhgMaxIterations = 100000;
+const int kPdhgCheckFrequency = 64;
+const double kPdhgTolerance = 1e-9;
+const int kPdhgRuizIterations = 10;
+
+// pdhg restarts: fractions of the KKT error at the last restart that always
+// allow a restart or allow one once progress stalls, and fraction of all
+// iterations after which a restart is forced
+const double kPdhgSufficientRestartFactor = 0.2;
+const double kPdhgNecessaryRestartFactor = 0.8;
+const double kPdhgArtificialRestartFactor = 0.36;
+
+// pdhg threads: most threads used, and fewest nonzeros for the matrix
+// products to be split over them
+const int kPdhgMaxThreads = 8;
+const int kPdhgParallelNonzeros = 1 << 16;
+
+// most variables of a problem retried with bland's rule on the full table
+// once the dual simplex gives no verdict, its dense table takes minutes on
+// larger ones
+const int kPrimalFallbackMaxVariables = 1000;
+
+// selection policy: largest bucket of the log2 of the columns and rows,
+// number of density buckets and largest bucket of the log10 of the
+// coefficient range
+const int kPolicyMaxSizeBucket = 6;
+const int kPolicyDensityBuckets = 4;
+const int kPolicyMaxRangeBucket = 2;
+
+// policy tuning: one problem in this many is sampled, and buckets with fewer
+// samples keep the default pipeline
+const int kPolicySampleStride = 4;
+const int kPolicyMinSamples = 32;
+
+// solve server: most problems a worker takes from the queue at once, how long
+// it waits for a batch to fill before solving what it has, and most workers
+const int kServerBatchSize = 64;
+const int kServerBatchDelayMicros = 200;
+const int kServerMaxWorkers = 8;
+
+// results files: number of results handed to the writer thread at a time
+const int kResultsBatchSize = 1024;
+
+// tolerances for the single precision tableau solvers
+const float kFloatFeasibilityTolerance = 1e-5;
+const float kFloatPivotTolerance = 1e-6;
+const float kFloatOptimalityTolerance = 1e-5;
+const float kFloatPerturbation = 1e-4;
+
 } // namespace core
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace core {
@@ -11,9 +13,18 @@ enum class PresolveRulesIds {
   parallelRowId,
   emptyColId,
   fixedColId,
-  freeColSubsId
+  freeColSubsId,
+  emptyRowId,
+  redundantRowId,
+  forcingRowId,
+  doubletonEquationId,
+  parallelColId,
+  dominatedColId
 };
 
+const int kNumPresolveRules =
+    static_cast<int>(PresolveRulesIds::dominatedColId) + 1;
+
 struct InputRows {
   std::vector<std::vector<float>> equality_rows;
   std::vector<std::vector<float>> inequality_rows;
@@ -36,16 +47,162 @@ struct FormattedLogicalProblem {
   std::vector<int> upper_bounds;
 };
 
+struct FormattedBoundedProblem {
+  std::vector<std::vector<double>> problem_matrix;
+  std::vector<double> row_lower_bounds;
+  std::vector<double> row_upper_bounds;
+  std::vector<double> column_lower_bounds;
+  std::vector<double> column_upper_bounds;
+};
+
+/**
+ * @brief Problem left once presolve has removed what it could, renumbered
+ * so that its rows and columns are contiguous. Columns are bounded by their
+ * implied bounds, which may stand in for rows presolve removed.
+ */
+struct ReducedProblem {
+  FormattedBoundedProblem problem;
+  // original index of each row and column of the reduced problem
+  std::vector<int> row_indices;
+  std::vector<int> column_indices;
+};
+
 struct DualSolution {
   std::vector<float> primal_variable_values;
   std::vector<float> slack_variable_values;
 };
 
+enum class PricingStrategy {
+  kBland = 0,
+  kDantzig,
+  kPartial,
+  kDevex,
+  kSteepestEdge
+};
+
+/**
+ * @brief counters gathered by a simplex solver over a single solve
+ */
+struct SimplexStats {
+  int num_iterations;
+  // pivots that did not change the objective (zero step)
+  int num_degenerate_iterations;
+  // bases revisited during the solve, i.e. detected cycles
+  int num_repeated_bases;
+  bool is_perturbed;
+};
+
+/**
+ * @brief counters gathered for a single presolve rule. The time is spent
+ * applying the rule, detection is timed per presolve phase
+ */
+struct PresolveRuleStats {
+  int num_applications;
+  int num_rows_removed;
+  int num_cols_removed;
+  std::uint64_t time_nanos;
+};
+
+/**
+ * @brief counters gathered by presolve, rule_stats is indexed by
+ * PresolveRulesIds
+ */
+struct PresolveStats {
+  std::vector<PresolveRuleStats> rule_stats;
+  int num_iterations;
+  std::uint64_t row_rules_time_nanos;
+  std::uint64_t activity_rules_time_nanos;
+  std::uint64_t col_rules_time_nanos;
+  std::uint64_t parallel_col_rules_time_nanos;
+  std::uint64_t doubleton_rules_time_nanos;
+  std::uint64_t postsolve_time_nanos;
+};
+
 enum class SolveStatus { kInfeasible = 0, kFeasible, kError, kDidntConverge };
 
+/**
+ * @brief cheap features of a problem as read, which a selection policy
+ * picks the solvers from
+ */
+struct ProblemFeatures {
+  int num_columns;
+  int num_rows;
+  // fraction of the rows that are equalities
+  double equality_share;
+  // fraction of the coefficients that are nonzero
+  double density;
+  // largest over smallest absolute nonzero coefficient
+  double coefficient_range;
+};
+
+/**
+ * @brief A problem as it is passed along a solver pipeline, with what the
+ * stages found out about it. Stages either solve the rows as read or the
+ * bounded problem, which presolve may have replaced by its reduced problem
+ */
+struct PipelineProblem {
+  InputRows rows;
+  // bounded form of the rows, or the reduced problem. Only set once a stage
+  // needs it
+  FormattedBoundedProblem bounded_problem;
+  bool is_bounded_set;
+  bool is_reduced;
+  // values of the columns of the bounded problem, left by the stage that
+  // found it feasible
+  std::vector<double> solution;
+  // values of the variables of the rows, when the stages could recover them
+  std::vector<double> variable_values;
+  // counters of every simplex solve made on the problem
+  std::vector<SimplexStats> simplex_stats;
+  // iterations of every interior point and PDHG solve made on the problem
+  std::vector<int> interior_point_iterations;
+  std::vector<int> pdhg_iterations;
+  PresolveStats presolve_stats;
+  bool is_presolved;
+};
+
+/**
+ * @brief outcome of one problem of a run, as written to a results file
+ */
+struct ProblemResult {
+  // position of the problem in its file, from 0
+  std::uint64_t index;
+  SolveStatus status;
+  // name of the solver that gave the verdict
+  std::string engine;
+  long long num_iterations;
+  std::uint64_t time_nanos;
+  // values of the variables when feasible and recovered, else empty
+  std::vector<double> solution;
+};
+
+/**
+ * @brief Common interface of the solvers a pipeline is built from. A stage
+ * either gives a verdict on the problem or passes it on to the next stage
+ * with kDidntConverge or kError, and then hears the final verdict through
+ * finishProblem()
+ */
 class ISolver {
 public:
-  virtual SolveStatus solveProblem() = 0;
+  virtual ~ISolver() = default;
+
+  /**
+   * @brief solve the problem or pass it on
+   *
+   * @param problem
+   * @return SolveStatus
+   */
+  virtual SolveStatus solveProblem(PipelineProblem &problem) = 0;
+
+  /**
+   * @brief called with the verdict of the later stages on a problem this
+   * stage passed on, in the reverse order of the stages
+   *
+   * @param solve_status
+   * @param problem
+   */
+  virtual void finishProblem(const SolveStatus /*solve_status*/,
+                             PipelineProblem & /*problem*/) {}
 };
 
 } // namespace core
\ No newline at end of file
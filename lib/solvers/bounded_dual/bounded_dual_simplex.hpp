@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+#include "../../utils/basis_hash.hpp"
+#include "bounded_dual_storage.hpp"
+
+namespace solvers::bounded_dual {
+
+/**
+ * @brief Dual simplex with bound flipping on [A | -I], every variable bounded
+ * natively. The containers come from the storage policy: DynamicStorage sizes
+ * them for each problem, FixedStorage is sized at compile time for small
+ * problems. Pivot choices do not depend on the storage, so the verdict,
+ * solution and counters of a solve do not either
+ *
+ * @tparam Storage DynamicStorage or FixedStorage
+ */
+template <typename Storage> class BasicBoundedDualSimplex {
+public:
+  BasicBoundedDualSimplex()
+      : is_perturbation_enabled_(false), is_perturbation_active_(false),
+        is_generator_seeded_(false), basis_hash_(0), iteration_count_(0),
+        stats_(), num_flipped_variables_(0) {}
+
+  /**
+   * @brief for fixed size storage, whose perturbation generator is shared
+   * between solvers
+   *
+   * @param perturbation_generator
+   */
+  explicit BasicBoundedDualSimplex(std::mt19937 &perturbation_generator)
+      : storage_(perturbation_generator), is_perturbation_enabled_(false),
+        is_perturbation_active_(false), is_generator_seeded_(false),
+        basis_hash_(0), iteration_count_(0), stats_(),
+        num_flipped_variables_(0) {}
+
+  /**
+   * @brief Set the problem to be solved. Each row i of the problem matrix is
+   * given a logical variable r_i = a_i x, bounded by the row bounds, so the
+   * solver works on [A | -I] with every variable bounded natively and free
+   * variables kept as a single column
+   *
+   * @param problem bounded problem
+   */
+  void setProblem(const core::FormattedBoundedProblem &problem) {
+    storage_.setSize(static_cast<int>(problem.problem_matrix.size()),
+                     static_cast<int>(problem.column_lower_bounds.size()));
+    const int num_rows = storage_.getNumRows();
+    const int num_columns = storage_.getNumColumns();
+
+    std::fill(storage_.values.begin(), storage_.values.end(), 0);
+    std::fill(storage_.reduced_costs.begin(), storage_.reduced_costs.end(), 0);
+    std::fill(storage_.basis_position.begin(), storage_.basis_position.end(),
+              -1);
+
+    for (int j = 0; j < num_columns; ++j) {
+      storage_.lower_bounds[j] = problem.column_lower_bounds.at(j);
+      storage_.upper_bounds[j] = problem.column_upper_bounds.at(j);
+    }
+    for (int i = 0; i < num_rows; ++i) {
+      storage_.lower_bounds[num_columns + i] = problem.row_lower_bounds.at(i);
+      storage_.upper_bounds[num_columns + i] = problem.row_upper_bounds.at(i);
+      for (int j = 0; j < num_columns; ++j) {
+        storage_.problem_matrix[static_cast<std::size_t>(i) * num_columns + j] =
+            problem.problem_matrix.at(i).at(j);
+      }
+    }
+
+    // structurals start nonbasic at a finite bound, or at zero if free. With
+    // zero costs every reduced cost is zero so this basis is dual feasible
+    for (int j = 0; j < num_columns; ++j) {
+      if (isFinite(storage_.lower_bounds[j])) {
+        storage_.values[j] = storage_.lower_bounds[j];
+      } else if (isFinite(storage_.upper_bounds[j])) {
+        storage_.values[j] = storage_.upper_bounds[j];
+      }
+    }
+
+    // logical basis, B = -I so the tableau is [-A | I] and r = A x
+    std::fill(storage_.table.begin(), storage_.table.end(), 0);
+    basis_hash_ = 0;
+    for (int i = 0; i < num_rows; ++i) {
+      double *row = getRow(i);
+      const double *matrix_row =
+          storage_.problem_matrix.data() +
+          static_cast<std::size_t>(i) * num_columns;
+      double activity = 0;
+      for (int j = 0; j < num_columns; ++j) {
+        row[j] = -matrix_row[j];
+        activity += matrix_row[j] * storage_.values[j];
+      }
+      row[num_columns + i] = 1;
+
+      storage_.basis[i] = num_columns + i;
+      storage_.basis_position[num_columns + i] = i;
+      basis_hash_ += utils::hashBasisColumn(num_columns + i);
+      storage_.values[num_columns + i] = activity;
+    }
+  }
+
+  /**
+   * @brief Warm start from a known basis, e.g. that of a similar problem
+   * solved before. Each given structural is pivoted into the basis in place
+   * of a row logical, with the logical left at its nearest bound. With zero
+   * costs any basis is dual feasible. Structurals that cannot be pivoted in
+   * are skipped. Must be called after setProblem()
+   *
+   * @param basic_variables structurals to make basic
+   */
+  void setBasis(const std::vector<int> &basic_variables) {
+    const int num_rows = storage_.getNumRows();
+    const int num_columns = storage_.getNumColumns();
+    for (const int j : basic_variables) {
+      if (j < 0 || j >= num_columns || storage_.basis_position[j] != -1) {
+        continue;
+      }
+
+      // pivot on the row with the largest entry whose logical is still basic
+      int pivot_row_index = -1;
+      double max_alpha = core::kPivotTolerance;
+      for (int i = 0; i < num_rows; ++i) {
+        const double alpha = std::fabs(getRow(i)[j]);
+        if (storage_.basis[i] >= num_columns && alpha > max_alpha) {
+          max_alpha = alpha;
+          pivot_row_index = i;
+        }
+      }
+      if (pivot_row_index == -1) {
+        continue;
+      }
+
+      // the leaving logical has to sit at a bound once nonbasic, free ones
+      // keep their value
+      const int leaving_index = storage_.basis[pivot_row_index];
+      const double value = storage_.values[leaving_index];
+      const double lower_bound = storage_.lower_bounds[leaving_index];
+      const double upper_bound = storage_.upper_bounds[leaving_index];
+      double leaving_value = value;
+      if (isFinite(lower_bound) &&
+          (!isFinite(upper_bound) ||
+           std::fabs(value - lower_bound) <= std::fabs(value - upper_bound))) {
+        leaving_value = lower_bound;
+      } else if (isFinite(upper_bound)) {
+        leaving_value = upper_bound;
+      }
+      pivot(pivot_row_index, j, leaving_value);
+    }
+  }
+
+  /**
+   * @brief returns the basic variable of each row, structurals are numbered
+   * first and row logicals after them
+   *
+   * @return std::vector<int>
+   */
+  std::vector<int> getBasis() {
+    return std::vector<int>(storage_.basis.begin(),
+                            storage_.basis.begin() + storage_.getNumRows());
+  }
+
+  /**
+   * @brief Enable or disable cost perturbation. All costs are zero, so every
+   * ratio in the dual ratio test ties at zero. With perturbation each
+   * variable leaving the basis has its cost shifted by a small random amount
+   * in the dual feasible direction, which separates the breakpoints. The
+   * shifts are dropped at the end of the solve; they never affect the primal
+   * values. Perturbation is also switched on for the rest of a solve once a
+   * basis is revisited
+   *
+   * @param is_perturbation_enabled
+   */
+  void setPerturbation(const bool is_perturbation_enabled) {
+    is_perturbation_enabled_ = is_perturbation_enabled;
+  }
+
+  /**
+   * @brief solve the given problem
+   *
+   */
+  core::SolveStatus solveProblem() {
+    // reset perturbation state and counters for this problem. The generator
+    // is seeded with a fixed seed on first use, so that solves are
+    // reproducible and those without perturbation skip the seeding
+    is_perturbation_active_ = is_perturbation_enabled_;
+    is_generator_seeded_ = false;
+    storage_.clearVisitedBases();
+    stats_ = core::SimplexStats();
+
+    const core::SolveStatus solve_status = runSimplex();
+
+    // drop the cost shifts, the primal values do not depend on them
+    std::fill(storage_.reduced_costs.begin(), storage_.reduced_costs.end(), 0);
+    stats_.is_perturbed = is_perturbation_active_;
+    return solve_status;
+  }
+
+  /**
+   * @brief returns the counters of the last solve
+   *
+   * @return core::SimplexStats
+   */
+  core::SimplexStats getStats() { return stats_; }
+
+  /**
+   * @brief returns the values of the structural variables once solved
+   *
+   * @return std::vector<double>
+   */
+  std::vector<double> getSolution() {
+    return std::vector<double>(storage_.values.begin(),
+                               storage_.values.begin() +
+                                   storage_.getNumColumns());
+  }
+
+  /**
+   * @brief returns the values of every variable once solved, the structurals
+   * come first. Unlike getSolution() nothing is copied
+   *
+   * @return const auto& container of the storage
+   */
+  const auto &getValues() const { return storage_.values; }
+
+  int getIterationCount() { return iteration_count_; }
+
+  void printSolution() {
+    std::cout << "Solution:" << std::endl;
+    for (int j = 0; j < storage_.getNumColumns(); ++j) {
+      std::cout << storage_.values[j] << " ";
+    }
+    std::cout << std::endl;
+  }
+
+private:
+  Storage storage_;
+
+  // perturbation selected by the user, whether costs are currently being
+  // shifted in this solve, and whether the generator is seeded for it
+  bool is_perturbation_enabled_;
+  bool is_perturbation_active_;
+  bool is_generator_seeded_;
+
+  // order independent hash of the basis
+  std::uint64_t basis_hash_;
+
+  int iteration_count_;
+  core::SimplexStats stats_;
+
+  // number of storage_.flipped_variables set by the last ratio test
+  int num_flipped_variables_;
+
+  static bool isFinite(const double value) {
+    return std::fabs(value) < core::kFloatInfinity;
+  }
+
+  double *getRow(const int row_index) {
+    return storage_.table.data() +
+           static_cast<std::size_t>(row_index) * storage_.getNumVariables();
+  }
+
+  /**
+   * @brief returns the row whose basic variable has the largest bound
+   * violation, or -1 if the basis is primal feasible
+   *
+   * @return int
+   */
+  int getPivotRowIndex() {
+    int pivot_row_index = -1;
+    double max_infeasibility = core::kFeasibilityTolerance;
+
+    for (int i = 0; i < storage_.getNumRows(); ++i) {
+      const int variable_index = storage_.basis[i];
+      const double value = storage_.values[variable_index];
+      double infeasibility = 0;
+      if (value < storage_.lower_bounds[variable_index]) {
+        infeasibility = storage_.lower_bounds[variable_index] - value;
+      } else if (value > storage_.upper_bounds[variable_index]) {
+        infeasibility = value - storage_.upper_bounds[variable_index];
+      }
+      if (infeasibility > max_infeasibility) {
+        max_infeasibility = infeasibility;
+        pivot_row_index = i;
+      }
+    }
+    return pivot_row_index;
+  }
+
+  /**
+   * @brief bound flipping ratio test on the pivot row. Boxed candidates whose
+   * breakpoint can be passed while the dual objective still improves are
+   * added to the flipped variables, the entering variable is returned.
+   * Returns -1 if the dual is unbounded, i.e. the problem is infeasible
+   *
+   * @param pivot_row_index found in getPivotRowIndex()
+   * @param infeasibility signed bound violation of the leaving variable
+   * @return int
+   */
+  int getPivotColumnIndex(const int pivot_row_index,
+                          const double infeasibility) {
+    const double *pivot_row = getRow(pivot_row_index);
+
+    // the basic value moves by -alpha_j per unit increase of x_j. When the
+    // leaving variable is below its lower bound (infeasibility < 0) it has to
+    // increase, so x_j must move against the sign of alpha_j
+    const double direction_sign = infeasibility < 0 ? -1.0 : 1.0;
+
+    int num_candidates = 0;
+    for (int j = 0; j < storage_.getNumVariables(); ++j) {
+      if (storage_.basis_position[j] != -1) {
+        continue;
+      }
+      const double alpha = pivot_row[j];
+      if (std::fabs(alpha) < core::kPivotTolerance) {
+        continue;
+      }
+      const double lower_bound = storage_.lower_bounds[j];
+      const double upper_bound = storage_.upper_bounds[j];
+      if (lower_bound == upper_bound) {
+        // fixed variables can never enter
+        continue;
+      }
+
+      // direction x_j has to move in, and whether its bounds allow it
+      const double move = alpha > 0 ? direction_sign : -direction_sign;
+      const bool is_free = !isFinite(lower_bound) && !isFinite(upper_bound);
+      const bool at_upper = !is_free && storage_.values[j] == upper_bound;
+      if (!is_free && ((move > 0 && at_upper) || (move < 0 && !at_upper))) {
+        continue;
+      }
+
+      storage_.candidates[num_candidates++] = {
+          j, std::fabs(storage_.reduced_costs[j]) / std::fabs(alpha),
+          std::fabs(alpha)};
+    }
+
+    if (num_candidates == 0) {
+      return -1;
+    }
+
+    // sort breakpoints, preferring large pivots between ties
+    std::sort(storage_.candidates.begin(),
+              storage_.candidates.begin() + num_candidates,
+              [](const RatioCandidate &a, const RatioCandidate &b) {
+                if (a.ratio != b.ratio) {
+                  return a.ratio < b.ratio;
+                }
+                return a.abs_alpha > b.abs_alpha;
+              });
+
+    // pass breakpoints of boxed variables while the slope of the dual
+    // objective stays positive, flipping those variables to their other
+    // bound. A slope within tolerance of zero means the flip alone would make
+    // the leaving variable feasible, so the variable is pivoted in instead of
+    // declaring the dual unbounded on round off
+    num_flipped_variables_ = 0;
+    double slope = std::fabs(infeasibility);
+    for (int k = 0; k < num_candidates; ++k) {
+      const RatioCandidate &candidate = storage_.candidates[k];
+      const int j = candidate.variable_index;
+      const double lower_bound = storage_.lower_bounds[j];
+      const double upper_bound = storage_.upper_bounds[j];
+      if (isFinite(lower_bound) && isFinite(upper_bound)) {
+        const double new_slope =
+            slope - candidate.abs_alpha * (upper_bound - lower_bound);
+        if (new_slope > core::kFeasibilityTolerance) {
+          storage_.flipped_variables[num_flipped_variables_++] = j;
+          slope = new_slope;
+          continue;
+        }
+      }
+      return j;
+    }
+
+    // every breakpoint was passed, the dual is unbounded
+    return -1;
+  }
+
+  /**
+   * @brief moves each flipped variable to its opposite bound and updates the
+   * basic variable values
+   */
+  void applyBoundFlips() {
+    for (int k = 0; k < num_flipped_variables_; ++k) {
+      const int j = storage_.flipped_variables[k];
+      const double new_value = storage_.values[j] == storage_.upper_bounds[j]
+                                   ? storage_.lower_bounds[j]
+                                   : storage_.upper_bounds[j];
+      const double change = new_value - storage_.values[j];
+      storage_.values[j] = new_value;
+
+      for (int i = 0; i < storage_.getNumRows(); ++i) {
+        storage_.values[storage_.basis[i]] -= getRow(i)[j] * change;
+      }
+    }
+  }
+
+  /**
+   * @brief updates values, reduced costs, basis and tableau for the pivot
+   *
+   * @param pivot_row_index
+   * @param pivot_column_index
+   * @param leaving_value bound the leaving variable is moved to
+   */
+  void pivot(const int pivot_row_index, const int pivot_column_index,
+             const double leaving_value) {
+    const int num_rows = storage_.getNumRows();
+    const int num_variables = storage_.getNumVariables();
+    double *pivot_row = getRow(pivot_row_index);
+    const double pivot_value = pivot_row[pivot_column_index];
+    const int leaving_index = storage_.basis[pivot_row_index];
+
+    // primal step moving the leaving variable onto its bound
+    const double primal_step =
+        (storage_.values[leaving_index] - leaving_value) / pivot_value;
+    for (int i = 0; i < num_rows; ++i) {
+      storage_.values[storage_.basis[i]] -=
+          getRow(i)[pivot_column_index] * primal_step;
+    }
+    storage_.values[pivot_column_index] += primal_step;
+    storage_.values[leaving_index] = leaving_value;
+
+    // dual step keeping the entering reduced cost at zero
+    const double dual_step =
+        storage_.reduced_costs[pivot_column_index] / pivot_value;
+    if (dual_step != 0) {
+      for (int j = 0; j < num_variables; ++j) {
+        storage_.reduced_costs[j] -= dual_step * pivot_row[j];
+      }
+    }
+    storage_.reduced_costs[pivot_column_index] = 0;
+
+    // update basis
+    storage_.basis[pivot_row_index] = pivot_column_index;
+    storage_.basis_position[pivot_column_index] = pivot_row_index;
+    storage_.basis_position[leaving_index] = -1;
+    basis_hash_ += utils::hashBasisColumn(pivot_column_index) -
+                   utils::hashBasisColumn(leaving_index);
+
+    // row operations on the tableau
+    for (int j = 0; j < num_variables; ++j) {
+      pivot_row[j] /= pivot_value;
+    }
+    for (int i = 0; i < num_rows; ++i) {
+      if (i == pivot_row_index) {
+        continue;
+      }
+      double *row = getRow(i);
+      const double multiplier = row[pivot_column_index];
+      if (std::fabs(multiplier) < core::kEpsilon) {
+        continue;
+      }
+      for (int j = 0; j < num_variables; ++j) {
+        row[j] -= multiplier * pivot_row[j];
+      }
+      row[pivot_column_index] = 0;
+    }
+  }
+
+  /**
+   * @brief shifts the cost of a variable that just left the basis so that its
+   * reduced cost is a small random value of the dual feasible sign
+   *
+   * @param variable_index leaving variable
+   * @param is_at_lower whether it left at its lower bound
+   */
+  void shiftCost(const int variable_index, const bool is_at_lower) {
+    std::mt19937 &perturbation_generator = storage_.getGenerator();
+    if (!is_generator_seeded_) {
+      perturbation_generator.seed(0);
+      is_generator_seeded_ = true;
+    }
+
+    // nonbasic variables at their lower bound need a nonnegative reduced
+    // cost, at their upper bound a nonpositive one
+    std::uniform_real_distribution<double> distribution(1, 2);
+    const double shift =
+        core::kPerturbation * distribution(perturbation_generator);
+    storage_.reduced_costs[variable_index] += is_at_lower ? shift : -shift;
+  }
+
+  /**
+   * @brief checks the structural values found against the original rows and
+   * column bounds
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus verifySolution() {
+    const int num_columns = storage_.getNumColumns();
+    for (int j = 0; j < num_columns; ++j) {
+      if (storage_.values[j] <
+              storage_.lower_bounds[j] - core::kFeasibilityTolerance ||
+          storage_.values[j] >
+              storage_.upper_bounds[j] + core::kFeasibilityTolerance) {
+        return core::SolveStatus::kError;
+      }
+    }
+
+    for (int i = 0; i < storage_.getNumRows(); ++i) {
+      const double *matrix_row = storage_.problem_matrix.data() +
+                                 static_cast<std::size_t>(i) * num_columns;
+      double activity = 0;
+      for (int j = 0; j < num_columns; ++j) {
+        activity += matrix_row[j] * storage_.values[j];
+      }
+      const int logical_index = num_columns + i;
+      if (activity < storage_.lower_bounds[logical_index] -
+                         core::kFeasibilityTolerance ||
+          activity > storage_.upper_bounds[logical_index] +
+                         core::kFeasibilityTolerance) {
+        return core::SolveStatus::kError;
+      }
+    }
+    return core::SolveStatus::kFeasible;
+  }
+
+  /**
+   * @brief dual simplex iterations run by solveProblem()
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus runSimplex() {
+    for (iteration_count_ = 0; iteration_count_ < core::kMaxIterations;
+         ++iteration_count_) {
+      const int pivot_row_index = getPivotRowIndex();
+      if (pivot_row_index == -1) {
+        return verifySolution();
+      }
+
+      const int leaving_index = storage_.basis[pivot_row_index];
+      const bool below_lower = storage_.values[leaving_index] <
+                               storage_.lower_bounds[leaving_index];
+      const double leaving_value = below_lower
+                                       ? storage_.lower_bounds[leaving_index]
+                                       : storage_.upper_bounds[leaving_index];
+      const double infeasibility =
+          storage_.values[leaving_index] - leaving_value;
+
+      const int pivot_column_index =
+          getPivotColumnIndex(pivot_row_index, infeasibility);
+      if (pivot_column_index == -1) {
+        return core::SolveStatus::kInfeasible;
+      }
+
+      ++stats_.num_iterations;
+      if (std::fabs(storage_.reduced_costs[pivot_column_index]) <
+          core::kEpsilon) {
+        ++stats_.num_degenerate_iterations;
+      }
+
+      applyBoundFlips();
+      pivot(pivot_row_index, pivot_column_index, leaving_value);
+      if (is_perturbation_active_) {
+        shiftCost(leaving_index, below_lower);
+      }
+
+      // a revisited basis means we are cycling, perturb from here on
+      if (storage_.visitBasis(basis_hash_)) {
+        ++stats_.num_repeated_bases;
+        is_perturbation_active_ = true;
+      }
+    }
+    return core::SolveStatus::kDidntConverge;
+  }
+};
+
+// solver sized for each problem
+using BoundedDualSimplex = BasicBoundedDualSimplex<DynamicStorage>;
+
+} // namespace solvers::bounded_dual
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace solvers::bounded_dual {
+
+/**
+ * @brief returns the number of ways to choose k items out of n, used to bound
+ * the number of distinct bases of a fixed size problem
+ *
+ * @param n
+ * @param k
+ * @return constexpr int
+ */
+constexpr int binomialCoefficient(const int n, const int k) {
+  int result = 1;
+  for (int i = 1; i <= k; ++i) {
+    result = result * (n - k + i) / i;
+  }
+  return result;
+}
+
+// breakpoint of the ratio test
+struct RatioCandidate {
+  int variable_index;
+  double ratio;
+  double abs_alpha;
+};
+
+/**
+ * @brief Storage of BasicBoundedDualSimplex sized when a problem is set. The
+ * containers are indexed like those of FixedStorage, only the first
+ * getNumRows() rows and getNumVariables() variables are used
+ */
+class DynamicStorage {
+public:
+  DynamicStorage() : num_rows_(0), num_columns_(0) {}
+
+  /**
+   * @brief size the containers for a problem
+   *
+   * @param num_rows
+   * @param num_columns structural columns
+   */
+  void setSize(const int num_rows, const int num_columns) {
+    num_rows_ = num_rows;
+    num_columns_ = num_columns;
+    const int num_variables = num_rows + num_columns;
+    problem_matrix.resize(static_cast<std::size_t>(num_rows) * num_columns);
+    table.resize(static_cast<std::size_t>(num_rows) * num_variables);
+    lower_bounds.resize(num_variables);
+    upper_bounds.resize(num_variables);
+    values.resize(num_variables);
+    reduced_costs.resize(num_variables);
+    basis.resize(num_rows);
+    basis_position.resize(num_variables);
+    candidates.resize(num_variables);
+    flipped_variables.resize(num_variables);
+  }
+
+  int getNumRows() const { return num_rows_; }
+  int getNumColumns() const { return num_columns_; }
+  int getNumVariables() const { return num_rows_ + num_columns_; }
+
+  std::mt19937 &getGenerator() { return perturbation_generator_; }
+
+  void clearVisitedBases() { visited_basis_hashes_.clear(); }
+
+  /**
+   * @brief records a basis, returning true if it was recorded before
+   *
+   * @param basis_hash
+   * @return bool
+   */
+  bool visitBasis(const std::uint64_t basis_hash) {
+    return !visited_basis_hashes_.insert(basis_hash).second;
+  }
+
+  // row major problem matrix, num_rows x num_columns
+  std::vector<double> problem_matrix;
+
+  // row major tableau B^-1 [A | -I], num_rows x num_variables
+  std::vector<double> table;
+
+  std::vector<double> lower_bounds;
+  std::vector<double> upper_bounds;
+  std::vector<double> values;
+  std::vector<double> reduced_costs;
+
+  std::vector<int> basis;
+  std::vector<int> basis_position;
+
+  std::vector<RatioCandidate> candidates;
+  std::vector<int> flipped_variables;
+
+private:
+  int num_rows_;
+  int num_columns_;
+  std::mt19937 perturbation_generator_;
+  std::unordered_set<std::uint64_t> visited_basis_hashes_;
+};
+
+/**
+ * @brief Storage of BasicBoundedDualSimplex for a problem of Rows rows and
+ * Cols columns known at compile time. Every container is a std::array, so a
+ * solve never allocates and the loops have fixed trip counts the compiler can
+ * unroll. The perturbation generator is shared, so that a solver can be made
+ * for each solve without seeding one
+ *
+ * @tparam Rows number of rows, at least one
+ * @tparam Cols number of structural columns, at least one
+ */
+template <int Rows, int Cols> class FixedStorage {
+  static_assert(Rows >= 1 && Cols >= 1, "a fixed size needs rows and columns");
+
+public:
+  explicit FixedStorage(std::mt19937 &perturbation_generator)
+      : perturbation_generator_(perturbation_generator),
+        num_visited_bases_(0) {}
+
+  /**
+   * @brief the sizes are fixed, a problem set must have Rows rows and Cols
+   * columns
+   *
+   * @param num_rows
+   * @param num_columns
+   */
+  void setSize(const int, const int) {}
+
+  static constexpr int getNumRows() { return Rows; }
+  static constexpr int getNumColumns() { return Cols; }
+  static constexpr int getNumVariables() { return Rows + Cols; }
+
+  std::mt19937 &getGenerator() { return perturbation_generator_; }
+
+  void clearVisitedBases() { num_visited_bases_ = 0; }
+
+  /**
+   * @brief records a basis, returning true if it was recorded before
+   *
+   * @param basis_hash
+   * @return bool
+   */
+  bool visitBasis(const std::uint64_t basis_hash) {
+    for (int k = 0; k < num_visited_bases_; ++k) {
+      if (visited_basis_hashes_[k] == basis_hash) {
+        return true;
+      }
+    }
+    // there are at most kMaxBases distinct hashes, the check is only a guard
+    if (num_visited_bases_ < kMaxBases) {
+      visited_basis_hashes_[num_visited_bases_++] = basis_hash;
+    }
+    return false;
+  }
+
+  std::array<double, Rows * Cols> problem_matrix;
+  std::array<double, Rows * (Rows + Cols)> table;
+
+  std::array<double, Rows + Cols> lower_bounds;
+  std::array<double, Rows + Cols> upper_bounds;
+  std::array<double, Rows + Cols> values;
+  std::array<double, Rows + Cols> reduced_costs;
+
+  std::array<int, Rows> basis;
+  std::array<int, Rows + Cols> basis_position;
+
+  std::array<RatioCandidate, Rows + Cols> candidates;
+  std::array<int, Rows + Cols> flipped_variables;
+
+private:
+  // a basis is revisited at the latest once every distinct one has been seen
+  static constexpr int kMaxBases = binomialCoefficient(Rows + Cols, Rows);
+
+  std::mt19937 &perturbation_generator_;
+  std::array<std::uint64_t, kMaxBases> visited_basis_hashes_;
+  int num_visited_bases_;
+};
+
+} // namespace solvers::bounded_dual
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "bounded_dual_simplex.hpp"
+#include "bounded_dual_storage.hpp"
+
+namespace solvers::bounded_dual {
+
+/**
+ * @brief BoundedDualSimplex for a problem of Rows rows and Cols columns known
+ * at compile time. It runs the same code on fixed size storage, so the
+ * verdict, solution and counters of a solve are those of BoundedDualSimplex
+ *
+ * @tparam Rows number of rows, at least one
+ * @tparam Cols number of structural columns, at least one
+ */
+template <int Rows, int Cols>
+using TinyBoundedDualSimplex = BasicBoundedDualSimplex<FixedStorage<Rows, Cols>>;
+
+} // namespace solvers::bounded_dual
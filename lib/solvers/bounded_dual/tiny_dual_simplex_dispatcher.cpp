@@ -0,0 +1,71 @@
+#include "tiny_dual_simplex_dispatcher.hpp"
+#include "tiny_bounded_dual_simplex.hpp"
+
+namespace solvers::bounded_dual {
+
+TinyDualSimplexDispatcher::TinyDualSimplexDispatcher()
+    : is_perturbation_enabled_(false), stats_() {
+  solution_.reserve(core::kTinySimplexMaxColumns);
+}
+
+void TinyDualSimplexDispatcher::setPerturbation(
+    const bool is_perturbation_enabled) {
+  is_perturbation_enabled_ = is_perturbation_enabled;
+}
+
+bool TinyDualSimplexDispatcher::isSupported(
+    const core::FormattedBoundedProblem &problem) {
+  const std::size_t num_rows = problem.problem_matrix.size();
+  const std::size_t num_columns = problem.column_lower_bounds.size();
+  return num_rows >= 1 && num_rows <= core::kTinySimplexMaxRows &&
+         num_columns >= 1 && num_columns <= core::kTinySimplexMaxColumns;
+}
+
+core::SimplexStats TinyDualSimplexDispatcher::getStats() { return stats_; }
+
+const std::vector<double> &TinyDualSimplexDispatcher::getSolution() {
+  return solution_;
+}
+
+template <int Rows, int Cols>
+core::SolveStatus TinyDualSimplexDispatcher::solveFixedSize(
+    const core::FormattedBoundedProblem &problem) {
+  TinyBoundedDualSimplex<Rows, Cols> solver(perturbation_generator_);
+  solver.setPerturbation(is_perturbation_enabled_);
+  solver.setProblem(problem);
+  const core::SolveStatus solve_status = solver.solveProblem();
+
+  stats_ = solver.getStats();
+  solution_.assign(solver.getValues().begin(),
+                   solver.getValues().begin() + Cols);
+  return solve_status;
+}
+
+template <std::size_t... Sizes>
+core::SolveStatus
+TinyDualSimplexDispatcher::dispatch(std::index_sequence<Sizes...>,
+                                    const int size,
+                                    const core::FormattedBoundedProblem &problem) {
+  // one comparison per instantiation, stopping at the matching one
+  core::SolveStatus solve_status = core::SolveStatus::kError;
+  static_cast<void>(
+      ((size == static_cast<int>(Sizes) &&
+        (solve_status = solveFixedSize<Sizes / core::kTinySimplexMaxColumns + 1,
+                                       Sizes % core::kTinySimplexMaxColumns +
+                                           1>(problem),
+         true)) ||
+       ...));
+  return solve_status;
+}
+
+core::SolveStatus TinyDualSimplexDispatcher::solveProblem(
+    const core::FormattedBoundedProblem &problem) {
+  const int num_rows = static_cast<int>(problem.problem_matrix.size());
+  const int num_columns = static_cast<int>(problem.column_lower_bounds.size());
+  return dispatch(std::make_index_sequence<kNumSizes>(),
+                  (num_rows - 1) * core::kTinySimplexMaxColumns + num_columns -
+                      1,
+                  problem);
+}
+
+} // namespace solvers::bounded_dual
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+
+namespace solvers::bounded_dual {
+
+/**
+ * @brief Picks the TinyBoundedDualSimplex instantiation matching the size of
+ * a problem. Every size with one to kTinySimplexMaxRows rows and one to
+ * kTinySimplexMaxColumns columns has one. Larger problems, and those without
+ * rows, are left to BoundedDualSimplex. Once constructed, solves do not
+ * allocate
+ */
+class TinyDualSimplexDispatcher {
+public:
+  TinyDualSimplexDispatcher();
+
+  /**
+   * @brief Enable or disable cost perturbation, as in
+   * BoundedDualSimplex::setPerturbation
+   *
+   * @param is_perturbation_enabled
+   */
+  void setPerturbation(const bool is_perturbation_enabled);
+
+  /**
+   * @brief returns whether the problem is small enough for a fixed size solver
+   *
+   * @param problem bounded problem
+   * @return bool
+   */
+  bool isSupported(const core::FormattedBoundedProblem &problem);
+
+  /**
+   * @brief solve a problem for which isSupported() holds
+   *
+   * @param problem bounded problem
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem(const core::FormattedBoundedProblem &problem);
+
+  /**
+   * @brief returns the counters of the last solve
+   *
+   * @return core::SimplexStats
+   */
+  core::SimplexStats getStats();
+
+  /**
+   * @brief returns the values of the structural variables once solved
+   *
+   * @return const std::vector<double>&
+   */
+  const std::vector<double> &getSolution();
+
+private:
+  // sizes are numbered (rows - 1) * kTinySimplexMaxColumns + columns - 1
+  static constexpr int kNumSizes =
+      core::kTinySimplexMaxRows * core::kTinySimplexMaxColumns;
+
+  bool is_perturbation_enabled_;
+  std::mt19937 perturbation_generator_;
+  core::SimplexStats stats_;
+
+  // reserved for the largest size, so copying a solution into it never
+  // allocates
+  std::vector<double> solution_;
+
+  template <int Rows, int Cols>
+  core::SolveStatus solveFixedSize(const core::FormattedBoundedProblem &problem);
+
+  template <std::size_t... Sizes>
+  core::SolveStatus dispatch(std::index_sequence<Sizes...>, const int size,
+                             const core::FormattedBoundedProblem &problem);
+};
+
+} // namespace solvers::bounded_dual
@@ -0,0 +1,285 @@
+#include "branch_and_bound.hpp"
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace solvers::branch_and_bound {
+
+BranchAndBound::BranchAndBound()
+    : num_inequality_rows_(0), num_equality_rows_(0), num_columns_(0),
+      node_limit_(core::kMaxBranchAndBoundNodes), node_count_(0), stats_() {}
+
+void BranchAndBound::setProblem(const core::FormattedLogicalProblem &problem,
+                                const int num_inequality_rows,
+                                const int num_equality_rows) {
+  problem_ = problem;
+  num_inequality_rows_ = num_inequality_rows;
+  num_equality_rows_ = num_equality_rows;
+  num_columns_ = problem.problem_matrix.empty()
+                     ? 0
+                     : static_cast<int>(problem.problem_matrix.at(0).size());
+}
+
+void BranchAndBound::setNodeLimit(const int node_limit) {
+  node_limit_ = node_limit;
+}
+
+std::vector<int> BranchAndBound::getSolution() { return solution_; }
+
+int BranchAndBound::getNodeCount() { return node_count_; }
+
+core::SimplexStats BranchAndBound::getStats() { return stats_; }
+
+void BranchAndBound::addStats(const core::SimplexStats &stats) {
+  stats_.num_iterations += stats.num_iterations;
+  stats_.num_degenerate_iterations += stats.num_degenerate_iterations;
+  stats_.num_repeated_bases += stats.num_repeated_bases;
+  stats_.is_perturbed = stats_.is_perturbed || stats.is_perturbed;
+}
+
+core::SolveStatus BranchAndBound::solveProblem() {
+  node_count_ = 0;
+  stats_ = core::SimplexStats();
+  solution_.clear();
+
+  Node root;
+  root.column_lower_bounds.assign(num_columns_, -core::kFloatInfinity);
+  root.column_upper_bounds.assign(num_columns_, core::kFloatInfinity);
+  std::vector<Node> nodes;
+  nodes.push_back(std::move(root));
+
+  // set if a node could not be solved or branched on, the tree then does not
+  // prove the problem infeasible
+  bool is_exhaustive = true;
+
+  while (!nodes.empty()) {
+    if (node_count_ >= node_limit_) {
+      return core::SolveStatus::kDidntConverge;
+    }
+    Node node = std::move(nodes.back());
+    nodes.pop_back();
+    ++node_count_;
+
+    std::vector<double> values;
+    std::vector<int> basic_columns;
+    const core::SolveStatus node_status =
+        solveNode(node, values, basic_columns);
+    if (node_status == core::SolveStatus::kInfeasible) {
+      continue;
+    }
+    if (node_status != core::SolveStatus::kFeasible) {
+      is_exhaustive = false;
+      continue;
+    }
+
+    bool is_integer = false;
+    const int j = getBranchingColumn(values, is_integer);
+    if (is_integer) {
+      return core::SolveStatus::kFeasible;
+    }
+    if (j == -1 || std::fabs(values.at(j)) >= core::kIntInfinity - 1) {
+      is_exhaustive = false;
+      continue;
+    }
+
+    const double down_value = std::floor(values.at(j));
+    Node down_node = node;
+    down_node.column_upper_bounds.at(j) = down_value;
+    down_node.basic_columns = basic_columns;
+    Node up_node = std::move(node);
+    up_node.column_lower_bounds.at(j) = down_value + 1;
+    up_node.basic_columns = std::move(basic_columns);
+
+    // the nearer side is explored first, so it goes on the stack last
+    if (values.at(j) - down_value > 0.5) {
+      nodes.push_back(std::move(down_node));
+      nodes.push_back(std::move(up_node));
+    } else {
+      nodes.push_back(std::move(up_node));
+      nodes.push_back(std::move(down_node));
+    }
+  }
+  return is_exhaustive ? core::SolveStatus::kInfeasible
+                       : core::SolveStatus::kError;
+}
+
+core::SolveStatus BranchAndBound::solveNode(const Node &node,
+                                            std::vector<double> &values,
+                                            std::vector<int> &basic_columns) {
+  // the branching bounds become singleton inequality rows after the original
+  // inequalities, which presolve turns back into column bounds
+  std::vector<std::vector<int>> problem_matrix(
+      problem_.problem_matrix.begin(),
+      problem_.problem_matrix.begin() + num_inequality_rows_);
+  std::vector<int> lower_bounds(problem_.lower_bounds.begin(),
+                                problem_.lower_bounds.begin() +
+                                    num_inequality_rows_);
+  std::vector<int> upper_bounds(problem_.upper_bounds.begin(),
+                                problem_.upper_bounds.begin() +
+                                    num_inequality_rows_);
+  for (int j = 0; j < num_columns_; ++j) {
+    const double lower_bound = node.column_lower_bounds.at(j);
+    const double upper_bound = node.column_upper_bounds.at(j);
+    if (std::fabs(lower_bound) < core::kFloatInfinity) {
+      problem_matrix.emplace_back(num_columns_, 0);
+      problem_matrix.back().at(j) = 1;
+      lower_bounds.push_back(static_cast<int>(lower_bound));
+      upper_bounds.push_back(core::kIntInfinity);
+    }
+    if (std::fabs(upper_bound) < core::kFloatInfinity) {
+      problem_matrix.emplace_back(num_columns_, 0);
+      problem_matrix.back().at(j) = -1;
+      lower_bounds.push_back(-static_cast<int>(upper_bound));
+      upper_bounds.push_back(core::kIntInfinity);
+    }
+  }
+  const int num_inequality_rows = static_cast<int>(problem_matrix.size());
+  for (int i = num_inequality_rows_;
+       i < num_inequality_rows_ + num_equality_rows_; ++i) {
+    problem_matrix.push_back(problem_.problem_matrix.at(i));
+    lower_bounds.push_back(problem_.lower_bounds.at(i));
+    upper_bounds.push_back(problem_.upper_bounds.at(i));
+  }
+
+  logical_solver::Presolve presolve(problem_matrix, lower_bounds, upper_bounds,
+                                    num_inequality_rows, num_equality_rows_,
+                                    false);
+  presolve.applyPresolve();
+  if (presolve.infeasible_) {
+    return core::SolveStatus::kInfeasible;
+  }
+  if (presolve.overflow_) {
+    return solveFullNode(node, values, basic_columns);
+  }
+  if (presolve.reduced_to_empty_) {
+    presolve.applyPostsolve();
+    if (presolve.infeasible_ || presolve.unsatisfied_constraints_) {
+      return solveFullNode(node, values, basic_columns);
+    }
+    values = presolve.getFeasibleSolution();
+    basic_columns = node.basic_columns;
+    return core::SolveStatus::kFeasible;
+  }
+
+  // warm start from the parent's basis, renumbered to the reduced columns
+  const core::ReducedProblem reduced_problem = presolve.getReducedProblem();
+  std::vector<int> reduced_positions(num_columns_, -1);
+  for (int k = 0; k < static_cast<int>(reduced_problem.column_indices.size());
+       ++k) {
+    reduced_positions.at(reduced_problem.column_indices.at(k)) = k;
+  }
+  std::vector<int> warm_start_basis;
+  for (const int j : node.basic_columns) {
+    if (reduced_positions.at(j) != -1) {
+      warm_start_basis.push_back(reduced_positions.at(j));
+    }
+  }
+  dual_solver_.setProblem(reduced_problem.problem);
+  dual_solver_.setBasis(warm_start_basis);
+  const core::SolveStatus solve_status = dual_solver_.solveProblem();
+  addStats(dual_solver_.getStats());
+  if (solve_status == core::SolveStatus::kInfeasible) {
+    return core::SolveStatus::kInfeasible;
+  }
+  if (solve_status != core::SolveStatus::kFeasible) {
+    return solveFullNode(node, values, basic_columns);
+  }
+
+  presolve.setReducedSolution(dual_solver_.getSolution());
+  presolve.applyPostsolve();
+  if (presolve.infeasible_ || presolve.unsatisfied_constraints_) {
+    return solveFullNode(node, values, basic_columns);
+  }
+  values = presolve.getFeasibleSolution();
+  basic_columns.clear();
+  for (const int variable_index : dual_solver_.getBasis()) {
+    if (variable_index <
+        static_cast<int>(reduced_problem.column_indices.size())) {
+      basic_columns.push_back(
+          reduced_problem.column_indices.at(variable_index));
+    }
+  }
+  return core::SolveStatus::kFeasible;
+}
+
+core::SolveStatus
+BranchAndBound::solveFullNode(const Node &node, std::vector<double> &values,
+                              std::vector<int> &basic_columns) {
+  core::FormattedBoundedProblem bounded_problem;
+  bounded_problem.column_lower_bounds = node.column_lower_bounds;
+  bounded_problem.column_upper_bounds = node.column_upper_bounds;
+  for (std::size_t i = 0; i < problem_.problem_matrix.size(); ++i) {
+    bounded_problem.problem_matrix.emplace_back(
+        problem_.problem_matrix.at(i).begin(),
+        problem_.problem_matrix.at(i).end());
+    const int lower_bound = problem_.lower_bounds.at(i);
+    const int upper_bound = problem_.upper_bounds.at(i);
+    bounded_problem.row_lower_bounds.push_back(
+        lower_bound == std::numeric_limits<int>::min() ? -core::kFloatInfinity
+                                                       : lower_bound);
+    bounded_problem.row_upper_bounds.push_back(
+        upper_bound == core::kIntInfinity ? core::kFloatInfinity
+                                          : upper_bound);
+  }
+
+  dual_solver_.setProblem(bounded_problem);
+  dual_solver_.setBasis(node.basic_columns);
+  const core::SolveStatus solve_status = dual_solver_.solveProblem();
+  addStats(dual_solver_.getStats());
+  if (solve_status != core::SolveStatus::kFeasible) {
+    return solve_status;
+  }
+
+  values = dual_solver_.getSolution();
+  basic_columns.clear();
+  for (const int variable_index : dual_solver_.getBasis()) {
+    if (variable_index < num_columns_) {
+      basic_columns.push_back(variable_index);
+    }
+  }
+  return core::SolveStatus::kFeasible;
+}
+
+int BranchAndBound::getBranchingColumn(const std::vector<double> &values,
+                                       bool &is_integer) {
+  is_integer = false;
+  int branching_column = -1;
+  double max_fractionality = core::kIntegralityTolerance;
+  std::vector<long long> rounded_values(num_columns_);
+  for (int j = 0; j < num_columns_; ++j) {
+    const double rounded_value = std::round(values.at(j));
+    const double fractionality = std::fabs(values.at(j) - rounded_value);
+    if (fractionality > max_fractionality) {
+      max_fractionality = fractionality;
+      branching_column = j;
+    }
+    if (std::fabs(rounded_value) >= core::kIntInfinity) {
+      return branching_column;
+    }
+    rounded_values.at(j) = static_cast<long long>(rounded_value);
+  }
+  if (branching_column != -1) {
+    return branching_column;
+  }
+
+  // every value is within tolerance of an integer, so check the rounded
+  // values exactly
+  for (std::size_t i = 0; i < problem_.problem_matrix.size(); ++i) {
+    long long activity = 0;
+    for (int j = 0; j < num_columns_; ++j) {
+      activity += problem_.problem_matrix.at(i).at(j) * rounded_values.at(j);
+    }
+    const int lower_bound = problem_.lower_bounds.at(i);
+    const int upper_bound = problem_.upper_bounds.at(i);
+    if ((lower_bound != std::numeric_limits<int>::min() &&
+         activity < lower_bound) ||
+        (upper_bound != core::kIntInfinity && activity > upper_bound)) {
+      return -1;
+    }
+  }
+  solution_.assign(rounded_values.begin(), rounded_values.end());
+  is_integer = true;
+  return -1;
+}
+
+} // namespace solvers::branch_and_bound
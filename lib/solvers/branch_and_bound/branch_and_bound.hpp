@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+#include "../bounded_dual/bounded_dual_simplex.hpp"
+#include "../logical_solver/presolve.hpp"
+
+namespace solvers::branch_and_bound {
+
+class BranchAndBound {
+public:
+  BranchAndBound();
+
+  /**
+   * @brief Set the problem to find an integer solution of, in the logical
+   * form used by presolve with the inequality rows first
+   *
+   * @param problem logical problem
+   * @param num_inequality_rows
+   * @param num_equality_rows
+   */
+  void setProblem(const core::FormattedLogicalProblem &problem,
+                  const int num_inequality_rows, const int num_equality_rows);
+
+  /**
+   * @brief Set the number of nodes explored before giving up
+   *
+   * @param node_limit
+   */
+  void setNodeLimit(const int node_limit);
+
+  /**
+   * @brief Depth first branch and bound on the LP relaxation. Each node is
+   * presolved and what is left is solved with the bounded dual simplex, warm
+   * started from the parent's basis. A fractional value x_j = v branches into
+   * x_j <= floor(v) and x_j >= ceil(v), the nearer side first. Returns
+   * kFeasible once an integer solution is found, kInfeasible if the tree is
+   * exhausted and kDidntConverge if the node limit is hit
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem();
+
+  /**
+   * @brief returns the integer solution found by the last solve
+   *
+   * @return std::vector<int>
+   */
+  std::vector<int> getSolution();
+
+  /**
+   * @brief returns the number of nodes explored by the last solve
+   *
+   * @return int
+   */
+  int getNodeCount();
+
+  /**
+   * @brief returns the simplex counters summed over every node of the last
+   * solve
+   *
+   * @return core::SimplexStats
+   */
+  core::SimplexStats getStats();
+
+private:
+  // original problem
+  core::FormattedLogicalProblem problem_;
+  int num_inequality_rows_;
+  int num_equality_rows_;
+  int num_columns_;
+
+  int node_limit_;
+  int node_count_;
+  std::vector<int> solution_;
+  core::SimplexStats stats_;
+
+  solvers::bounded_dual::BoundedDualSimplex dual_solver_;
+
+  // column bounds added by branching, and the structurals that were basic
+  // in the parent's solve
+  struct Node {
+    std::vector<double> column_lower_bounds;
+    std::vector<double> column_upper_bounds;
+    std::vector<int> basic_columns;
+  };
+
+  /**
+   * @brief solves the LP relaxation of a node, filling values with a solution
+   * of the original problem and basic_columns with the basic structurals
+   *
+   * @param node
+   * @param values
+   * @param basic_columns
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveNode(const Node &node, std::vector<double> &values,
+                              std::vector<int> &basic_columns);
+
+  /**
+   * @brief solves the node without presolve, used when presolve cannot give
+   * a trusted solution
+   *
+   * @param node
+   * @param values
+   * @param basic_columns
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveFullNode(const Node &node, std::vector<double> &values,
+                                  std::vector<int> &basic_columns);
+
+  /**
+   * @brief rounds values and checks every row in integer arithmetic. Fills
+   * solution_ if they round to an integer solution, otherwise returns the
+   * most fractional column to branch on, or -1 if there is none
+   *
+   * @param values
+   * @param is_integer set if values round to an integer solution
+   * @return int
+   */
+  int getBranchingColumn(const std::vector<double> &values, bool &is_integer);
+
+  void addStats(const core::SimplexStats &stats);
+};
+
+} // namespace solvers::branch_and_bound
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "../../core/consts.hpp"
 #include "../../core/types.hpp"
 
@@ -0,0 +1,336 @@
+#include "fourier_motzkin.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace solvers::fourier_motzkin {
+
+FourierMotzkin::FourierMotzkin()
+    : num_columns_(0), num_problem_rows_(0), row_size_(1), num_rows_(0),
+      max_row_count_(0), is_integer_(true) {}
+
+const std::vector<double> &FourierMotzkin::getSolution() { return solution_; }
+
+int FourierMotzkin::getMaxRowCount() { return max_row_count_; }
+
+bool FourierMotzkin::isFinite(const double value) {
+  return std::fabs(value) < core::kFloatInfinity;
+}
+
+double *FourierMotzkin::getRow(std::vector<double> &rows,
+                               const int row_index) {
+  return rows.data() + static_cast<std::size_t>(row_index) * row_size_;
+}
+
+void FourierMotzkin::addRow(const double *coefficients,
+                            const int column_index, const double coefficient,
+                            const double bound) {
+  if (!isFinite(bound)) {
+    return;
+  }
+
+  // bounds presolve implied by dividing through a coefficient are ratios of
+  // integers, scaling by the denominator keeps the row exact. Other bounds
+  // are rounded outwards, which can only make the problem more feasible
+  double scale = 1;
+  while (std::floor(scale * bound) != scale * bound &&
+         scale < core::kFourierMotzkinMaxDenominator) {
+    ++scale;
+  }
+  double scaled_bound = scale * bound;
+  if (std::floor(scaled_bound) != scaled_bound) {
+    scale = 1;
+    scaled_bound = std::ceil(bound);
+  }
+
+  rows_.resize(rows_.size() + row_size_, 0);
+  double *row = getRow(rows_, num_rows_);
+  if (coefficients == nullptr) {
+    row[column_index] = scale * coefficient;
+  } else {
+    for (int j = 0; j < num_columns_; ++j) {
+      row[j] = scale * coefficient * coefficients[j];
+    }
+  }
+  row[num_columns_] = scaled_bound;
+  ++num_rows_;
+}
+
+void FourierMotzkin::setProblem(const core::FormattedBoundedProblem &problem) {
+  num_columns_ = problem.column_lower_bounds.size();
+  num_problem_rows_ = problem.problem_matrix.size();
+  row_size_ = num_columns_ + 1;
+
+  problem_rows_.resize(static_cast<std::size_t>(num_problem_rows_) *
+                       num_columns_);
+  problem_row_lower_bounds_ = problem.row_lower_bounds;
+  problem_row_upper_bounds_ = problem.row_upper_bounds;
+  problem_column_lower_bounds_ = problem.column_lower_bounds;
+  problem_column_upper_bounds_ = problem.column_upper_bounds;
+
+  // the verdict is only exact on integer coefficients, bounds are scaled or
+  // rounded as their rows are built
+  is_integer_ = true;
+  for (int i = 0; i < num_problem_rows_; ++i) {
+    for (int j = 0; j < num_columns_; ++j) {
+      const double coefficient = problem.problem_matrix.at(i).at(j);
+      problem_rows_.at(static_cast<std::size_t>(i) * num_columns_ + j) =
+          coefficient;
+      is_integer_ = is_integer_ && std::floor(coefficient) == coefficient &&
+                    std::fabs(coefficient) < core::kMaxExactInteger;
+    }
+  }
+}
+
+bool FourierMotzkin::pruneRows() {
+  // divide by the gcd of the whole row so that it stays integer
+  int num_nonzero_rows = 0;
+  for (int i = 0; i < num_rows_; ++i) {
+    double *row = getRow(rows_, i);
+    std::int64_t divisor = 0;
+    for (int j = 0; j < num_columns_; ++j) {
+      divisor = std::gcd(divisor, static_cast<std::int64_t>(row[j]));
+    }
+    if (divisor == 0) {
+      if (row[num_columns_] < 0) {
+        return false;
+      }
+      continue;
+    }
+    divisor = std::gcd(divisor, static_cast<std::int64_t>(row[num_columns_]));
+    double *kept_row = getRow(rows_, num_nonzero_rows);
+    for (int j = 0; j <= num_columns_; ++j) {
+      kept_row[j] = row[j] / static_cast<double>(divisor);
+    }
+    ++num_nonzero_rows;
+  }
+  num_rows_ = num_nonzero_rows;
+
+  // rows with the same coefficients sort next to each other, the tightest
+  // first
+  row_order_.resize(num_rows_);
+  std::iota(row_order_.begin(), row_order_.end(), 0);
+  std::sort(row_order_.begin(), row_order_.end(), [this](const int a,
+                                                         const int b) {
+    const double *row_a = getRow(rows_, a);
+    const double *row_b = getRow(rows_, b);
+    return std::lexicographical_compare(row_a, row_a + row_size_, row_b,
+                                        row_b + row_size_);
+  });
+
+  next_rows_.resize(static_cast<std::size_t>(num_rows_) * row_size_);
+  int num_kept_rows = 0;
+  const double *previous_row = nullptr;
+  for (const int i : row_order_) {
+    const double *row = getRow(rows_, i);
+    if (previous_row != nullptr &&
+        std::equal(row, row + num_columns_, previous_row)) {
+      continue;
+    }
+    std::copy(row, row + row_size_, getRow(next_rows_, num_kept_rows));
+    previous_row = row;
+    ++num_kept_rows;
+  }
+  next_rows_.resize(static_cast<std::size_t>(num_kept_rows) * row_size_);
+  rows_.swap(next_rows_);
+  num_rows_ = num_kept_rows;
+  return true;
+}
+
+int FourierMotzkin::getEliminationColumn() {
+  int elimination_column = -1;
+  long long min_growth = 0;
+  for (int j = 0; j < num_columns_; ++j) {
+    if (is_column_eliminated_.at(j)) {
+      continue;
+    }
+    long long num_positive = 0;
+    long long num_negative = 0;
+    for (int i = 0; i < num_rows_; ++i) {
+      const double coefficient = getRow(rows_, i)[j];
+      num_positive += coefficient > 0;
+      num_negative += coefficient < 0;
+    }
+    const long long growth =
+        num_positive * num_negative - num_positive - num_negative;
+    if (elimination_column == -1 || growth < min_growth) {
+      elimination_column = j;
+      min_growth = growth;
+    }
+  }
+  return elimination_column;
+}
+
+bool FourierMotzkin::eliminateColumn(const int column_index) {
+  int num_positive = 0;
+  int num_negative = 0;
+  for (int i = 0; i < num_rows_; ++i) {
+    const double coefficient = getRow(rows_, i)[column_index];
+    num_positive += coefficient > 0;
+    num_negative += coefficient < 0;
+  }
+  const int num_next_rows =
+      num_rows_ - num_positive - num_negative + num_positive * num_negative;
+  if (num_next_rows > core::kFourierMotzkinMaxRows) {
+    return false;
+  }
+
+  // rows without the column carry over, the others are saved for back
+  // substitution
+  next_rows_.resize(static_cast<std::size_t>(num_next_rows) * row_size_);
+  int num_kept_rows = 0;
+  for (int i = 0; i < num_rows_; ++i) {
+    const double *row = getRow(rows_, i);
+    if (row[column_index] == 0) {
+      std::copy(row, row + row_size_, getRow(next_rows_, num_kept_rows));
+      ++num_kept_rows;
+    } else {
+      eliminated_rows_.insert(eliminated_rows_.end(), row, row + row_size_);
+    }
+  }
+  eliminated_columns_.push_back(column_index);
+  eliminated_row_offsets_.push_back(
+      static_cast<int>(eliminated_rows_.size() / row_size_));
+  is_column_eliminated_.at(column_index) = true;
+
+  // a_p x <= b_p with a_pk > 0 and a_n x <= b_n with a_nk < 0 combine into
+  // -a_nk (a_p x) + a_pk (a_n x) <= -a_nk b_p + a_pk b_n, free of x_k
+  for (int p = 0; p < num_rows_; ++p) {
+    const double *positive_row = getRow(rows_, p);
+    const double positive_multiplier = positive_row[column_index];
+    if (positive_multiplier <= 0) {
+      continue;
+    }
+    for (int n = 0; n < num_rows_; ++n) {
+      const double *negative_row = getRow(rows_, n);
+      const double negative_multiplier = -negative_row[column_index];
+      if (negative_multiplier <= 0) {
+        continue;
+      }
+      double *row = getRow(next_rows_, num_kept_rows);
+      for (int j = 0; j < row_size_; ++j) {
+        row[j] = negative_multiplier * positive_row[j] +
+                 positive_multiplier * negative_row[j];
+        // past this the products and sums may have been rounded
+        if (std::fabs(row[j]) >= core::kMaxExactInteger) {
+          return false;
+        }
+      }
+      row[column_index] = 0;
+      ++num_kept_rows;
+    }
+  }
+  rows_.swap(next_rows_);
+  num_rows_ = num_kept_rows;
+  max_row_count_ = std::max(max_row_count_, num_rows_);
+  return true;
+}
+
+void FourierMotzkin::backSubstitute() {
+  solution_.assign(num_columns_, 0);
+  for (int k = static_cast<int>(eliminated_columns_.size()) - 1; k >= 0;
+       --k) {
+    const int column_index = eliminated_columns_.at(k);
+    double lower_bound = -core::kInfinity;
+    double upper_bound = core::kInfinity;
+    for (int i = eliminated_row_offsets_.at(k);
+         i < eliminated_row_offsets_.at(k + 1); ++i) {
+      const double *row = getRow(eliminated_rows_, i);
+      // columns eliminated earlier have zero coefficients and are still zero
+      double residual = row[num_columns_];
+      for (int j = 0; j < num_columns_; ++j) {
+        if (j != column_index) {
+          residual -= row[j] * solution_.at(j);
+        }
+      }
+      const double limit = residual / row[column_index];
+      if (row[column_index] > 0) {
+        upper_bound = std::min(upper_bound, limit);
+      } else {
+        lower_bound = std::max(lower_bound, limit);
+      }
+    }
+
+    // the middle of the range leaves the most room for round off
+    if (isFinite(lower_bound) && isFinite(upper_bound)) {
+      solution_.at(column_index) = (lower_bound + upper_bound) / 2;
+    } else if (isFinite(lower_bound)) {
+      solution_.at(column_index) = lower_bound;
+    } else if (isFinite(upper_bound)) {
+      solution_.at(column_index) = upper_bound;
+    }
+  }
+}
+
+core::SolveStatus FourierMotzkin::verifySolution() {
+  for (int j = 0; j < num_columns_; ++j) {
+    if (solution_.at(j) <
+            problem_column_lower_bounds_.at(j) - core::kFeasibilityTolerance ||
+        solution_.at(j) >
+            problem_column_upper_bounds_.at(j) + core::kFeasibilityTolerance) {
+      return core::SolveStatus::kError;
+    }
+  }
+  for (int i = 0; i < num_problem_rows_; ++i) {
+    double activity = 0;
+    for (int j = 0; j < num_columns_; ++j) {
+      activity +=
+          problem_rows_.at(static_cast<std::size_t>(i) * num_columns_ + j) *
+          solution_.at(j);
+    }
+    if (activity <
+            problem_row_lower_bounds_.at(i) - core::kFeasibilityTolerance ||
+        activity >
+            problem_row_upper_bounds_.at(i) + core::kFeasibilityTolerance) {
+      return core::SolveStatus::kError;
+    }
+  }
+  return core::SolveStatus::kFeasible;
+}
+
+core::SolveStatus FourierMotzkin::solveProblem() {
+  solution_.clear();
+  max_row_count_ = 0;
+  if (!is_integer_) {
+    return core::SolveStatus::kDidntConverge;
+  }
+
+  // l <= a x <= u becomes a x <= u and -a x <= -l, column bounds likewise
+  rows_.clear();
+  num_rows_ = 0;
+  for (int i = 0; i < num_problem_rows_; ++i) {
+    const double *coefficients =
+        problem_rows_.data() + static_cast<std::size_t>(i) * num_columns_;
+    addRow(coefficients, 0, 1, problem_row_upper_bounds_.at(i));
+    addRow(coefficients, 0, -1, -problem_row_lower_bounds_.at(i));
+  }
+  for (int j = 0; j < num_columns_; ++j) {
+    addRow(nullptr, j, 1, problem_column_upper_bounds_.at(j));
+    addRow(nullptr, j, -1, -problem_column_lower_bounds_.at(j));
+  }
+  max_row_count_ = num_rows_;
+
+  eliminated_columns_.clear();
+  eliminated_rows_.clear();
+  eliminated_row_offsets_.assign(1, 0);
+  is_column_eliminated_.assign(num_columns_, false);
+
+  for (int k = 0; k < num_columns_; ++k) {
+    if (!pruneRows()) {
+      return core::SolveStatus::kInfeasible;
+    }
+    if (!eliminateColumn(getEliminationColumn())) {
+      return core::SolveStatus::kDidntConverge;
+    }
+  }
+
+  // only rows reading 0 <= b are left
+  if (!pruneRows()) {
+    return core::SolveStatus::kInfeasible;
+  }
+
+  backSubstitute();
+  return verifySolution();
+}
+
+} // namespace solvers::fourier_motzkin
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+
+namespace solvers::fourier_motzkin {
+
+/**
+ * @brief Feasibility by Fourier-Motzkin elimination. Every row and column
+ * bound becomes an inequality a x <= b, and columns are eliminated one at a
+ * time by combining each inequality where the column has a positive
+ * coefficient with each one where it is negative. The problem is infeasible
+ * iff a combination reduces to 0 <= b with b < 0.
+ *
+ * Coefficients are integers and combinations are taken with integer
+ * multipliers, so the verdict is exact as long as every value stays below
+ * kMaxExactInteger. Fractional bounds are scaled to integers when they have
+ * a small denominator and rounded outwards otherwise; a feasible verdict
+ * always rests on a witness checked against the original rows. The solver
+ * gives up rather than risk a wrong verdict, and also when the number of
+ * inequalities grows past kFourierMotzkinMaxRows
+ */
+class FourierMotzkin {
+public:
+  FourierMotzkin();
+
+  /**
+   * @brief Set the problem to be solved
+   *
+   * @param problem bounded problem
+   */
+  void setProblem(const core::FormattedBoundedProblem &problem);
+
+  /**
+   * @brief Eliminate every column. Returns kFeasible or kInfeasible when
+   * elimination finishes, and kDidntConverge if it was given up because of
+   * non integer coefficients, too many inequalities or values too large to be
+   * exact. A feasible verdict comes with a witness found by back
+   * substitution; if it fails the original rows within tolerance kError is
+   * returned
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem();
+
+  /**
+   * @brief returns the witness of the last feasible solve, one value per
+   * column
+   *
+   * @return const std::vector<double>&
+   */
+  const std::vector<double> &getSolution();
+
+  /**
+   * @brief returns the largest number of inequalities held at once during
+   * the last solve
+   *
+   * @return int
+   */
+  int getMaxRowCount();
+
+private:
+  int num_columns_;
+  int num_problem_rows_;
+
+  // a row is num_columns_ coefficients followed by its right hand side,
+  // stored contiguously. Rows of the original problem are kept for
+  // verification
+  int row_size_;
+  std::vector<double> problem_rows_;
+  std::vector<double> problem_row_lower_bounds_;
+  std::vector<double> problem_row_upper_bounds_;
+  std::vector<double> problem_column_lower_bounds_;
+  std::vector<double> problem_column_upper_bounds_;
+
+  // inequalities a x <= b over the columns not yet eliminated, and the
+  // buffer the next set is built in
+  std::vector<double> rows_;
+  std::vector<double> next_rows_;
+  int num_rows_;
+  int max_row_count_;
+
+  // whether every coefficient is an integer
+  bool is_integer_;
+
+  // eliminated columns in order, with the inequalities that contained each
+  // one. These only involve columns eliminated later, which back
+  // substitution sets first
+  std::vector<int> eliminated_columns_;
+  std::vector<double> eliminated_rows_;
+  std::vector<int> eliminated_row_offsets_;
+  std::vector<char> is_column_eliminated_;
+
+  std::vector<int> row_order_;
+  std::vector<double> solution_;
+
+  double *getRow(std::vector<double> &rows, const int row_index);
+
+  /**
+   * @brief appends a x <= b to rows_, if b is finite
+   *
+   * @param coefficients num_columns_ coefficients, or nullptr for a single
+   * nonzero
+   * @param column_index column of the single nonzero
+   * @param coefficient value of the single nonzero
+   * @param bound b
+   */
+  void addRow(const double *coefficients, const int column_index,
+              const double coefficient, const double bound);
+
+  /**
+   * @brief divides each row by the gcd of its entries, drops rows without
+   * coefficients and keeps the tightest of rows with equal coefficients.
+   * Returns false if a row reads 0 <= b with b < 0
+   *
+   * @return bool
+   */
+  bool pruneRows();
+
+  /**
+   * @brief returns the column whose elimination adds the fewest rows
+   *
+   * @return int
+   */
+  int getEliminationColumn();
+
+  /**
+   * @brief replaces the rows containing the column by their pairwise
+   * combinations, saving them for back substitution. Returns false if the
+   * threshold on rows or magnitudes is hit
+   *
+   * @param column_index
+   * @return bool
+   */
+  bool eliminateColumn(const int column_index);
+
+  /**
+   * @brief sets the eliminated columns in reverse order, each within the
+   * range its saved rows allow given the columns already set
+   *
+   */
+  void backSubstitute();
+
+  /**
+   * @brief checks the witness against the original rows and column bounds
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus verifySolution();
+
+  bool isFinite(const double value);
+};
+
+} // namespace solvers::fourier_motzkin
@@ -0,0 +1,353 @@
+#include "interior_point.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace solvers::interior_point {
+
+InteriorPoint::InteriorPoint()
+    : num_variables_(0), num_rows_(0), num_program_variables_(0),
+      iteration_count_(0) {}
+
+std::vector<double> InteriorPoint::getSolution() { return solution_; }
+
+int InteriorPoint::getIterationCount() { return iteration_count_; }
+
+void InteriorPoint::setProblem(const core::InputRows &problem) {
+  // the reader counts the constant term as a variable
+  num_variables_ = problem.num_variables - 1;
+  num_rows_ = problem.inequality_rows.size() + 2 * problem.equality_rows.size();
+  num_program_variables_ = 2 * num_variables_ + 2 * num_rows_;
+
+  // rows g x + c >= 0, each equality also negated
+  std::vector<const std::vector<float> *> rows;
+  std::vector<double> signs;
+  rows.reserve(num_rows_);
+  signs.reserve(num_rows_);
+  for (const std::vector<float> &row : problem.inequality_rows) {
+    rows.push_back(&row);
+    signs.push_back(1);
+  }
+  for (const std::vector<float> &row : problem.equality_rows) {
+    rows.push_back(&row);
+    signs.push_back(1);
+    rows.push_back(&row);
+    signs.push_back(-1);
+  }
+
+  constants_.resize(num_rows_);
+  rhs_.resize(num_rows_);
+  for (int i = 0; i < num_rows_; ++i) {
+    constants_.at(i) = signs.at(i) * rows.at(i)->at(0);
+    rhs_.at(i) = -constants_.at(i);
+  }
+  column_starts_.assign(num_variables_ + 1, 0);
+  row_indices_.clear();
+  values_.clear();
+  for (int j = 0; j < num_variables_; ++j) {
+    column_starts_.at(j) = row_indices_.size();
+    for (int i = 0; i < num_rows_; ++i) {
+      const double value = signs.at(i) * rows.at(i)->at(j + 1);
+      if (value != 0) {
+        row_indices_.push_back(i);
+        values_.push_back(value);
+      }
+    }
+  }
+  column_starts_.at(num_variables_) = row_indices_.size();
+
+  // the normal equations are G (D+ + D-) G^T plus a diagonal, one entry for
+  // each pair of nonzeros sharing a column of G and one per diagonal element
+  entry_rows_.clear();
+  entry_columns_.clear();
+  product_columns_.clear();
+  product_first_.clear();
+  product_second_.clear();
+  for (int i = 0; i < num_rows_; ++i) {
+    entry_rows_.push_back(i);
+    entry_columns_.push_back(i);
+  }
+  for (int j = 0; j < num_variables_; ++j) {
+    for (int p = column_starts_.at(j); p < column_starts_.at(j + 1); ++p) {
+      for (int q = p; q < column_starts_.at(j + 1); ++q) {
+        entry_rows_.push_back(row_indices_.at(q));
+        entry_columns_.push_back(row_indices_.at(p));
+        product_columns_.push_back(j);
+        product_first_.push_back(p);
+        product_second_.push_back(q);
+      }
+    }
+  }
+  entry_values_.resize(entry_rows_.size());
+  cholesky_.analysePattern(num_rows_, entry_rows_, entry_columns_);
+
+  // only the residual t is charged for
+  costs_.assign(num_program_variables_, 0);
+  std::fill(costs_.begin() + 2 * num_variables_ + num_rows_, costs_.end(), 1);
+
+  primal_.resize(num_program_variables_);
+  dual_.resize(num_rows_);
+  dual_slack_.resize(num_program_variables_);
+  scaling_.resize(num_program_variables_);
+  primal_residual_.resize(num_rows_);
+  dual_residual_.resize(num_program_variables_);
+  complementarity_residual_.resize(num_program_variables_);
+  primal_step_.resize(num_program_variables_);
+  dual_step_.resize(num_rows_);
+  dual_slack_step_.resize(num_program_variables_);
+  affine_primal_step_.resize(num_program_variables_);
+  affine_dual_slack_step_.resize(num_program_variables_);
+}
+
+void InteriorPoint::multiply(const std::vector<double> &primal,
+                             std::vector<double> &result) {
+  const int slack_start = 2 * num_variables_;
+  const int residual_start = slack_start + num_rows_;
+  for (int i = 0; i < num_rows_; ++i) {
+    result[i] = primal[residual_start + i] - primal[slack_start + i];
+  }
+  for (int j = 0; j < num_variables_; ++j) {
+    const double value = primal[j] - primal[num_variables_ + j];
+    for (int p = column_starts_[j]; p < column_starts_[j + 1]; ++p) {
+      result[row_indices_[p]] += values_[p] * value;
+    }
+  }
+}
+
+void InteriorPoint::multiplyTransposed(const std::vector<double> &dual,
+                                       std::vector<double> &result) {
+  const int slack_start = 2 * num_variables_;
+  const int residual_start = slack_start + num_rows_;
+  for (int j = 0; j < num_variables_; ++j) {
+    double value = 0;
+    for (int p = column_starts_[j]; p < column_starts_[j + 1]; ++p) {
+      value += values_[p] * dual[row_indices_[p]];
+    }
+    result[j] = value;
+    result[num_variables_ + j] = -value;
+  }
+  for (int i = 0; i < num_rows_; ++i) {
+    result[slack_start + i] = -dual[i];
+    result[residual_start + i] = dual[i];
+  }
+}
+
+void InteriorPoint::factoriseNormalEquations(
+    const std::vector<double> &scaling) {
+  const int slack_start = 2 * num_variables_;
+  const int residual_start = slack_start + num_rows_;
+  for (int i = 0; i < num_rows_; ++i) {
+    entry_values_[i] = scaling[slack_start + i] + scaling[residual_start + i];
+  }
+  for (std::size_t e = 0; e < product_columns_.size(); ++e) {
+    const int j = product_columns_[e];
+    entry_values_[num_rows_ + e] = values_[product_first_[e]] *
+                                   values_[product_second_[e]] *
+                                   (scaling[j] + scaling[num_variables_ + j]);
+  }
+  cholesky_.factorise(entry_values_);
+}
+
+void InteriorPoint::solveNewtonSystem() {
+  // with D = Z / W, dz = W^-1 r_c - D r_d + D M^T dy and
+  // M D M^T dy = r_p - M (W^-1 r_c - D r_d)
+  work_.resize(num_program_variables_);
+  for (int j = 0; j < num_program_variables_; ++j) {
+    work_[j] = complementarity_residual_[j] / dual_slack_[j] -
+               scaling_[j] * dual_residual_[j];
+  }
+  multiply(work_, dual_step_);
+  for (int i = 0; i < num_rows_; ++i) {
+    dual_step_[i] = primal_residual_[i] - dual_step_[i];
+  }
+  cholesky_.solve(dual_step_);
+
+  multiplyTransposed(dual_step_, primal_step_);
+  for (int j = 0; j < num_program_variables_; ++j) {
+    dual_slack_step_[j] = dual_residual_[j] - primal_step_[j];
+    primal_step_[j] = work_[j] + scaling_[j] * primal_step_[j];
+  }
+}
+
+void InteriorPoint::setStartingPoint() {
+  // z = M^T (M M^T)^-1 b, y = (M M^T)^-1 M c and w = c - M^T y
+  std::fill(scaling_.begin(), scaling_.end(), 1);
+  factoriseNormalEquations(scaling_);
+
+  std::vector<double> &dual_work = dual_step_;
+  dual_work = rhs_;
+  cholesky_.solve(dual_work);
+  multiplyTransposed(dual_work, primal_);
+
+  multiply(costs_, dual_);
+  cholesky_.solve(dual_);
+  multiplyTransposed(dual_, dual_slack_);
+  for (int j = 0; j < num_program_variables_; ++j) {
+    dual_slack_[j] = costs_[j] - dual_slack_[j];
+  }
+
+  // shift both to be positive, then balance the products
+  const double min_primal = *std::min_element(primal_.begin(), primal_.end());
+  const double min_dual_slack =
+      *std::min_element(dual_slack_.begin(), dual_slack_.end());
+  const double primal_shift = std::max(-1.5 * min_primal, 0.0);
+  const double dual_slack_shift = std::max(-1.5 * min_dual_slack, 0.0);
+  double product = 0;
+  double primal_sum = 0;
+  double dual_slack_sum = 0;
+  for (int j = 0; j < num_program_variables_; ++j) {
+    primal_[j] += primal_shift;
+    dual_slack_[j] += dual_slack_shift;
+    product += primal_[j] * dual_slack_[j];
+    primal_sum += primal_[j];
+    dual_slack_sum += dual_slack_[j];
+  }
+  const double primal_balance =
+      dual_slack_sum > 0 ? 0.5 * product / dual_slack_sum : 0;
+  const double dual_slack_balance =
+      primal_sum > 0 ? 0.5 * product / primal_sum : 0;
+  for (int j = 0; j < num_program_variables_; ++j) {
+    primal_[j] += primal_balance;
+    dual_slack_[j] += dual_slack_balance;
+    // only reached when the shifted point is all zero
+    if (primal_[j] <= 0) {
+      primal_[j] = 1;
+    }
+    if (dual_slack_[j] <= 0) {
+      dual_slack_[j] = 1;
+    }
+  }
+}
+
+double InteriorPoint::getMaxStep(const std::vector<double> &values,
+                                 const std::vector<double> &change) {
+  double max_step = 1;
+  for (std::size_t j = 0; j < values.size(); ++j) {
+    if (change[j] < 0) {
+      max_step = std::min(max_step, -values[j] / change[j]);
+    }
+  }
+  return max_step;
+}
+
+core::SolveStatus InteriorPoint::verifySolution() {
+  solution_.resize(num_variables_);
+  for (int j = 0; j < num_variables_; ++j) {
+    solution_[j] = primal_[j] - primal_[num_variables_ + j];
+  }
+  work_.assign(constants_.begin(), constants_.end());
+  for (int j = 0; j < num_variables_; ++j) {
+    for (int p = column_starts_[j]; p < column_starts_[j + 1]; ++p) {
+      work_[row_indices_[p]] += values_[p] * solution_[j];
+    }
+  }
+  for (int i = 0; i < num_rows_; ++i) {
+    if (work_[i] < -core::kFeasibilityTolerance) {
+      return core::SolveStatus::kError;
+    }
+  }
+  return core::SolveStatus::kFeasible;
+}
+
+core::SolveStatus InteriorPoint::solveProblem() {
+  solution_.clear();
+  if (num_rows_ == 0) {
+    solution_.assign(num_variables_, 0);
+    return core::SolveStatus::kFeasible;
+  }
+  setStartingPoint();
+
+  double rhs_norm = 0;
+  for (const double value : rhs_) {
+    rhs_norm = std::max(rhs_norm, std::fabs(value));
+  }
+
+  for (iteration_count_ = 0;
+       iteration_count_ < core::kInteriorPointMaxIterations;
+       ++iteration_count_) {
+    if (verifySolution() == core::SolveStatus::kFeasible) {
+      return core::SolveStatus::kFeasible;
+    }
+
+    multiply(primal_, primal_residual_);
+    multiplyTransposed(dual_, dual_residual_);
+    double primal_infeasibility = 0;
+    double dual_infeasibility = 0;
+    double dual_objective = 0;
+    for (int i = 0; i < num_rows_; ++i) {
+      primal_residual_[i] = rhs_[i] - primal_residual_[i];
+      primal_infeasibility =
+          std::max(primal_infeasibility, std::fabs(primal_residual_[i]));
+      dual_objective += rhs_[i] * dual_[i];
+    }
+    double gap = 0;
+    for (int j = 0; j < num_program_variables_; ++j) {
+      dual_residual_[j] = costs_[j] - dual_residual_[j] - dual_slack_[j];
+      dual_infeasibility =
+          std::max(dual_infeasibility, std::fabs(dual_residual_[j]));
+      gap += primal_[j] * dual_slack_[j];
+    }
+    const double mu = gap / num_program_variables_;
+
+    // b^T y bounds sum t from below once y is dual feasible. Rows feasible
+    // within tolerance keep sum t below num_rows_ times the tolerance
+    if (dual_infeasibility < core::kInteriorPointTolerance &&
+        dual_objective > num_rows_ * core::kFeasibilityTolerance) {
+      return core::SolveStatus::kInfeasible;
+    }
+    if (primal_infeasibility < core::kInteriorPointTolerance * (1 + rhs_norm) &&
+        dual_infeasibility < core::kInteriorPointTolerance &&
+        mu < core::kInteriorPointTolerance) {
+      return core::SolveStatus::kError;
+    }
+
+    for (int j = 0; j < num_program_variables_; ++j) {
+      scaling_[j] = primal_[j] / dual_slack_[j];
+    }
+    factoriseNormalEquations(scaling_);
+
+    // predictor, the pure Newton step towards complementarity
+    for (int j = 0; j < num_program_variables_; ++j) {
+      complementarity_residual_[j] = -primal_[j] * dual_slack_[j];
+    }
+    solveNewtonSystem();
+    const double affine_primal_length = getMaxStep(primal_, primal_step_);
+    const double affine_dual_length =
+        getMaxStep(dual_slack_, dual_slack_step_);
+    double affine_gap = 0;
+    for (int j = 0; j < num_program_variables_; ++j) {
+      affine_gap +=
+          (primal_[j] + affine_primal_length * primal_step_[j]) *
+          (dual_slack_[j] + affine_dual_length * dual_slack_step_[j]);
+    }
+    const double affine_mu = affine_gap / num_program_variables_;
+    const double centering = std::pow(affine_mu / mu, 3);
+    affine_primal_step_.swap(primal_step_);
+    affine_dual_slack_step_.swap(dual_slack_step_);
+
+    // corrector, centred and compensating the second order term of the
+    // predictor
+    for (int j = 0; j < num_program_variables_; ++j) {
+      complementarity_residual_[j] =
+          centering * mu - primal_[j] * dual_slack_[j] -
+          affine_primal_step_[j] * affine_dual_slack_step_[j];
+    }
+    solveNewtonSystem();
+
+    const double primal_length =
+        std::min(1.0, core::kInteriorPointStepFraction *
+                          getMaxStep(primal_, primal_step_));
+    const double dual_length =
+        std::min(1.0, core::kInteriorPointStepFraction *
+                          getMaxStep(dual_slack_, dual_slack_step_));
+    for (int j = 0; j < num_program_variables_; ++j) {
+      primal_[j] += primal_length * primal_step_[j];
+      dual_slack_[j] += dual_length * dual_slack_step_[j];
+    }
+    for (int i = 0; i < num_rows_; ++i) {
+      dual_[i] += dual_length * dual_step_[i];
+    }
+  }
+  return core::SolveStatus::kDidntConverge;
+}
+
+} // namespace solvers::interior_point
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+#include "sparse_cholesky.hpp"
+
+namespace solvers::interior_point {
+
+/**
+ * @brief Mehrotra predictor-corrector interior point method on the
+ * feasibility problem. Each row is written g_i x + c_i >= 0, equalities as a
+ * pair of opposite rows, and given a residual s_i - t_i, which leaves the
+ * linear program
+ *
+ *   min sum t  s.t.  G x+ - G x- - s + t = -c,  x+, x-, s, t >= 0
+ *
+ * It always has an optimum, zero iff the rows are feasible. Every Newton step
+ * solves the normal equations G D G^T + E, whose pattern is that of G G^T,
+ * with a sparse Cholesky factorisation analysed once per problem.
+ *
+ * A feasible verdict is given as soon as x = x+ - x- satisfies every row
+ * within kFeasibilityTolerance. An infeasible verdict needs a dual solution
+ * proving that sum t is bounded away from zero
+ */
+class InteriorPoint {
+public:
+  InteriorPoint();
+
+  /**
+   * @brief Set the problem to be solved
+   *
+   * @param problem problem as returned by the reader
+   */
+  void setProblem(const core::InputRows &problem);
+
+  /**
+   * @brief Run the interior point method. Returns kFeasible or kInfeasible
+   * once proven, kError if it converged without either and kDidntConverge if
+   * it ran out of iterations
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem();
+
+  /**
+   * @brief returns the point found by the last feasible solve
+   *
+   * @return std::vector<double>
+   */
+  std::vector<double> getSolution();
+
+  /**
+   * @brief returns the number of iterations of the last solve
+   *
+   * @return int
+   */
+  int getIterationCount();
+
+private:
+  int num_variables_;
+  int num_rows_;
+
+  // size of the linear program, x+, x-, s and t
+  int num_program_variables_;
+
+  // G column wise, each row's constant c, and -c as the right hand side
+  std::vector<int> column_starts_;
+  std::vector<int> row_indices_;
+  std::vector<double> values_;
+  std::vector<double> constants_;
+  std::vector<double> rhs_;
+
+  // primal, dual and dual slack iterates
+  std::vector<double> primal_;
+  std::vector<double> dual_;
+  std::vector<double> dual_slack_;
+  std::vector<double> costs_;
+
+  // normal equations: row and column of each entry of the lower triangle,
+  // and for each entry of G G^T the column of G it comes from and the
+  // positions in values_ of its two factors
+  SparseCholesky cholesky_;
+  std::vector<int> entry_rows_;
+  std::vector<int> entry_columns_;
+  std::vector<double> entry_values_;
+  std::vector<int> product_columns_;
+  std::vector<int> product_first_;
+  std::vector<int> product_second_;
+  std::vector<double> scaling_;
+
+  // residuals and Newton directions, the affine ones are kept for the
+  // corrector
+  std::vector<double> primal_residual_;
+  std::vector<double> dual_residual_;
+  std::vector<double> complementarity_residual_;
+  std::vector<double> primal_step_;
+  std::vector<double> dual_step_;
+  std::vector<double> dual_slack_step_;
+  std::vector<double> affine_primal_step_;
+  std::vector<double> affine_dual_slack_step_;
+  std::vector<double> work_;
+  std::vector<double> solution_;
+
+  int iteration_count_;
+
+  /**
+   * @brief y = M z for the constraint matrix M = [G, -G, -I, I]
+   *
+   * @param primal z
+   * @param result y
+   */
+  void multiply(const std::vector<double> &primal, std::vector<double> &result);
+
+  /**
+   * @brief z = M^T y
+   *
+   * @param dual y
+   * @param result z
+   */
+  void multiplyTransposed(const std::vector<double> &dual,
+                          std::vector<double> &result);
+
+  /**
+   * @brief factorises M D M^T for the diagonal scaling D
+   *
+   * @param scaling D
+   */
+  void factoriseNormalEquations(const std::vector<double> &scaling);
+
+  /**
+   * @brief Newton direction for the given residuals with the current
+   * factorisation, written to primal_step_, dual_step_ and dual_slack_step_
+   *
+   */
+  void solveNewtonSystem();
+
+  /**
+   * @brief Mehrotra's starting point, least squares solutions of the primal
+   * and dual equations shifted to be strictly positive
+   *
+   */
+  void setStartingPoint();
+
+  /**
+   * @brief returns the largest step in [0, 1] keeping values + step * change
+   * nonnegative
+   *
+   * @param values
+   * @param change
+   * @return double
+   */
+  double getMaxStep(const std::vector<double> &values,
+                    const std::vector<double> &change);
+
+  /**
+   * @brief checks x = x+ - x- against every row
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus verifySolution();
+};
+
+} // namespace solvers::interior_point
@@ -0,0 +1,220 @@
+#include "sparse_cholesky.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace solvers::interior_point {
+
+SparseCholesky::SparseCholesky() : size_(0) {}
+
+int SparseCholesky::getFactorSize() { return row_indices_.size(); }
+
+void SparseCholesky::analysePattern(const int size,
+                                    const std::vector<int> &entry_rows,
+                                    const std::vector<int> &entry_columns) {
+  size_ = size;
+
+  // graph of the matrix, rows adjacent when an entry joins them
+  std::vector<std::vector<int>> adjacency(size_);
+  for (std::size_t e = 0; e < entry_rows.size(); ++e) {
+    const int i = entry_rows.at(e);
+    const int j = entry_columns.at(e);
+    if (i != j) {
+      adjacency.at(i).push_back(j);
+      adjacency.at(j).push_back(i);
+    }
+  }
+  for (std::vector<int> &neighbours : adjacency) {
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                     neighbours.end());
+  }
+
+  // minimum degree: eliminate the row with the fewest neighbours, which
+  // joins its neighbours into a clique. Its neighbours at that point are the
+  // rows of its column of L
+  permutation_.assign(size_, -1);
+  inverse_permutation_.assign(size_, -1);
+  std::vector<std::vector<int>> factor_columns(size_);
+  std::vector<char> is_eliminated(size_, false);
+  std::vector<int> merged;
+  for (int k = 0; k < size_; ++k) {
+    int pivot = -1;
+    for (int i = 0; i < size_; ++i) {
+      if (!is_eliminated.at(i) &&
+          (pivot == -1 ||
+           adjacency.at(i).size() < adjacency.at(pivot).size())) {
+        pivot = i;
+      }
+    }
+
+    // once the row of least degree is joined to every other the graph is
+    // complete, and so is the rest of L in any order
+    const int num_remaining = size_ - k;
+    if (static_cast<int>(adjacency.at(pivot).size()) == num_remaining - 1) {
+      std::vector<int> remaining;
+      for (int i = 0; i < size_; ++i) {
+        if (!is_eliminated.at(i)) {
+          remaining.push_back(i);
+        }
+      }
+      for (int r = 0; r < num_remaining; ++r) {
+        permutation_.at(remaining.at(r)) = k + r;
+        inverse_permutation_.at(k + r) = remaining.at(r);
+        factor_columns.at(k + r).assign(remaining.begin() + r + 1,
+                                        remaining.end());
+      }
+      break;
+    }
+
+    is_eliminated.at(pivot) = true;
+    permutation_.at(pivot) = k;
+    inverse_permutation_.at(k) = pivot;
+
+    const std::vector<int> &neighbours = adjacency.at(pivot);
+    factor_columns.at(k) = neighbours;
+    for (const int i : neighbours) {
+      merged.clear();
+      std::set_union(adjacency.at(i).begin(), adjacency.at(i).end(),
+                     neighbours.begin(), neighbours.end(),
+                     std::back_inserter(merged));
+      merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                  [&](const int n) {
+                                    return n == i || n == pivot;
+                                  }),
+                   merged.end());
+      adjacency.at(i).swap(merged);
+    }
+    adjacency.at(pivot).clear();
+  }
+
+  // pattern of L in the elimination order
+  column_starts_.assign(size_ + 1, 0);
+  row_indices_.clear();
+  for (int k = 0; k < size_; ++k) {
+    column_starts_.at(k) = row_indices_.size();
+    row_indices_.push_back(k);
+    const std::size_t first = row_indices_.size();
+    for (const int i : factor_columns.at(k)) {
+      row_indices_.push_back(permutation_.at(i));
+    }
+    std::sort(row_indices_.begin() + first, row_indices_.end());
+  }
+  column_starts_.at(size_) = row_indices_.size();
+  values_.assign(row_indices_.size(), 0);
+
+  // rows of L, for the updates of the left looking factorisation
+  row_list_starts_.assign(size_ + 1, 0);
+  for (int k = 0; k < size_; ++k) {
+    for (int p = column_starts_.at(k) + 1; p < column_starts_.at(k + 1); ++p) {
+      ++row_list_starts_.at(row_indices_.at(p) + 1);
+    }
+  }
+  for (int i = 0; i < size_; ++i) {
+    row_list_starts_.at(i + 1) += row_list_starts_.at(i);
+  }
+  row_list_columns_.resize(row_list_starts_.at(size_));
+  row_list_positions_.resize(row_list_starts_.at(size_));
+  std::vector<int> next(row_list_starts_.begin(), row_list_starts_.end() - 1);
+  for (int k = 0; k < size_; ++k) {
+    for (int p = column_starts_.at(k) + 1; p < column_starts_.at(k + 1); ++p) {
+      const int q = next.at(row_indices_.at(p))++;
+      row_list_columns_.at(q) = k;
+      row_list_positions_.at(q) = p;
+    }
+  }
+
+  // entries of the matrix land in the lower triangle of the reordered one,
+  // which is covered by the pattern of L
+  entry_positions_.resize(entry_rows.size());
+  for (std::size_t e = 0; e < entry_rows.size(); ++e) {
+    const int i = permutation_.at(entry_rows.at(e));
+    const int j = permutation_.at(entry_columns.at(e));
+    const int row = std::max(i, j);
+    const int column = std::min(i, j);
+    const auto first = row_indices_.begin() + column_starts_.at(column);
+    const auto last = row_indices_.begin() + column_starts_.at(column + 1);
+    entry_positions_.at(e) =
+        row == column ? column_starts_.at(column)
+                      : std::lower_bound(first + 1, last, row) -
+                            row_indices_.begin();
+  }
+  work_.assign(size_, 0);
+}
+
+int SparseCholesky::factorise(const std::vector<double> &entry_values) {
+  std::fill(values_.begin(), values_.end(), 0);
+  double max_diagonal = 0;
+  for (std::size_t e = 0; e < entry_values.size(); ++e) {
+    values_.at(entry_positions_.at(e)) += entry_values.at(e);
+  }
+  for (int k = 0; k < size_; ++k) {
+    max_diagonal = std::max(max_diagonal, values_.at(column_starts_.at(k)));
+  }
+
+  int num_replaced_pivots = 0;
+  for (int j = 0; j < size_; ++j) {
+    const int start = column_starts_.at(j);
+    const int end = column_starts_.at(j + 1);
+    for (int p = start; p < end; ++p) {
+      work_[row_indices_[p]] = values_[p];
+    }
+
+    // subtract the contributions of the earlier columns with a nonzero in
+    // row j, from row j down
+    for (int q = row_list_starts_.at(j); q < row_list_starts_.at(j + 1); ++q) {
+      const int k = row_list_columns_[q];
+      const int position = row_list_positions_[q];
+      const double factor = values_[position];
+      for (int p = position; p < column_starts_[k + 1]; ++p) {
+        work_[row_indices_[p]] -= values_[p] * factor;
+      }
+    }
+
+    double pivot = work_[j];
+    if (pivot <= core::kCholeskyPivotTolerance * max_diagonal) {
+      pivot = core::kCholeskyHugePivot;
+      ++num_replaced_pivots;
+    }
+    const double diagonal = std::sqrt(pivot);
+    values_[start] = diagonal;
+    work_[j] = 0;
+    for (int p = start + 1; p < end; ++p) {
+      values_[p] = work_[row_indices_[p]] / diagonal;
+      work_[row_indices_[p]] = 0;
+    }
+  }
+  return num_replaced_pivots;
+}
+
+void SparseCholesky::solve(std::vector<double> &rhs) {
+  for (int i = 0; i < size_; ++i) {
+    work_[permutation_[i]] = rhs[i];
+  }
+
+  // L y = b
+  for (int j = 0; j < size_; ++j) {
+    const int start = column_starts_[j];
+    work_[j] /= values_[start];
+    for (int p = start + 1; p < column_starts_[j + 1]; ++p) {
+      work_[row_indices_[p]] -= values_[p] * work_[j];
+    }
+  }
+
+  // L^T x = y
+  for (int j = size_ - 1; j >= 0; --j) {
+    const int start = column_starts_[j];
+    double value = work_[j];
+    for (int p = start + 1; p < column_starts_[j + 1]; ++p) {
+      value -= values_[p] * work_[row_indices_[p]];
+    }
+    work_[j] = value / values_[start];
+  }
+
+  for (int i = 0; i < size_; ++i) {
+    rhs[i] = work_[permutation_[i]];
+    work_[permutation_[i]] = 0;
+  }
+}
+
+} // namespace solvers::interior_point
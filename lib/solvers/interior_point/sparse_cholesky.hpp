@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include "../../core/consts.hpp"
+
+namespace solvers::interior_point {
+
+/**
+ * @brief Cholesky factorisation L L^T of a sparse symmetric positive
+ * semidefinite matrix. The sparsity pattern is analysed once: rows are
+ * reordered by minimum degree to limit fill and the pattern of L is found
+ * while doing so. The matrix can then be factorised and solved with any
+ * number of times for new values on the same pattern.
+ *
+ * Pivots that are tiny compared to the diagonal are replaced by a huge value,
+ * which zeroes the matching component of a solve instead of failing, as the
+ * normal equations of an interior point method become singular near the
+ * optimum
+ */
+class SparseCholesky {
+public:
+  SparseCholesky();
+
+  /**
+   * @brief Analyse the pattern of the lower triangle of the matrix, given by
+   * the row and column of each entry. Entries may repeat, their values are
+   * summed
+   *
+   * @param size number of rows and columns
+   * @param entry_rows row of each entry, at least its column
+   * @param entry_columns column of each entry
+   */
+  void analysePattern(const int size, const std::vector<int> &entry_rows,
+                      const std::vector<int> &entry_columns);
+
+  /**
+   * @brief Factorise the matrix with the given values, in the order of the
+   * entries passed to analysePattern(). Returns the number of pivots that
+   * were replaced
+   *
+   * @param entry_values
+   * @return int
+   */
+  int factorise(const std::vector<double> &entry_values);
+
+  /**
+   * @brief Solve L L^T x = b in place
+   *
+   * @param rhs b on input, x on output
+   */
+  void solve(std::vector<double> &rhs);
+
+  /**
+   * @brief returns the number of nonzeros of L
+   *
+   * @return int
+   */
+  int getFactorSize();
+
+private:
+  int size_;
+
+  // position of each row in the elimination order and the row at each
+  // position
+  std::vector<int> permutation_;
+  std::vector<int> inverse_permutation_;
+
+  // L column wise in the elimination order, the diagonal first in each
+  // column and the other rows ascending
+  std::vector<int> column_starts_;
+  std::vector<int> row_indices_;
+  std::vector<double> values_;
+
+  // for each row, the earlier columns with a nonzero in it and the position
+  // of that nonzero
+  std::vector<int> row_list_starts_;
+  std::vector<int> row_list_columns_;
+  std::vector<int> row_list_positions_;
+
+  // position in values_ each entry of the matrix is added to
+  std::vector<int> entry_positions_;
+
+  std::vector<double> work_;
+};
+
+} // namespace solvers::interior_point
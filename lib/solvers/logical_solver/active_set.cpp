@@ -0,0 +1,50 @@
+#include "active_set.hpp"
+
+namespace logical_solver {
+
+ActiveSet::ActiveSet() : size_(0), count_(0) {}
+
+void ActiveSet::reset(const int size, const bool is_active) {
+  size_ = size;
+  count_ = is_active ? size : 0;
+  bits_.assign((size + 63) / 64, is_active ? ~std::uint64_t(0) : 0);
+
+  // clear the bits past the end so next() never returns them
+  if (is_active && size % 64 != 0) {
+    bits_.back() = (std::uint64_t(1) << (size % 64)) - 1;
+  }
+}
+
+void ActiveSet::activate(const int index) {
+  if (isActive(index)) {
+    return;
+  }
+  bits_.at(index >> 6) |= std::uint64_t(1) << (index & 63);
+  ++count_;
+}
+
+void ActiveSet::deactivate(const int index) {
+  if (!isActive(index)) {
+    return;
+  }
+  bits_.at(index >> 6) &= ~(std::uint64_t(1) << (index & 63));
+  --count_;
+}
+
+int ActiveSet::next(const int index) const {
+  if (index >= size_) {
+    return size_;
+  }
+  std::size_t word_index = index >> 6;
+  std::uint64_t word = bits_.at(word_index) & (~std::uint64_t(0) << (index & 63));
+  while (word == 0) {
+    ++word_index;
+    if (word_index >= bits_.size()) {
+      return size_;
+    }
+    word = bits_.at(word_index);
+  }
+  return word_index * 64 + __builtin_ctzll(word);
+}
+
+} // namespace logical_solver
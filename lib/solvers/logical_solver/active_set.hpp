@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace logical_solver {
+
+/**
+ * @brief Set of the indices 0 to size - 1 kept as a packed bitset, for
+ * constant time membership tests and updates, and in order iteration
+ * which skips 64 inactive indices at a time.
+ */
+class ActiveSet {
+public:
+  ActiveSet();
+
+  /**
+   * @brief Resizes the set, making every index active or inactive.
+   *
+   * @param int size: number of indices.
+   * @param bool is_active: whether the indices start active.
+   * @return void.
+   */
+  void reset(const int size, const bool is_active);
+
+  /**
+   * @brief Checks if an index is active.
+   *
+   * @param int index.
+   * @return bool.
+   */
+  bool isActive(const int index) const {
+    return (bits_.at(index >> 6) >> (index & 63)) & 1;
+  }
+
+  /**
+   * @brief Makes an index active, does nothing if it already is.
+   *
+   * @param int index.
+   * @return void.
+   */
+  void activate(const int index);
+
+  /**
+   * @brief Makes an index inactive, does nothing if it already is.
+   *
+   * @param int index.
+   * @return void.
+   */
+  void deactivate(const int index);
+
+  /**
+   * @brief Gets the smallest active index from index onwards, so that
+   * for (i = set.next(0); i < set.size(); i = set.next(i + 1)) visits
+   * the active indices in order. Indices deactivated during the loop
+   * are not visited.
+   *
+   * @param int index: index to search from.
+   * @return int active index, or size() if there is none.
+   */
+  int next(const int index) const;
+
+  /**
+   * @brief Gets the number of active indices.
+   *
+   * @return int.
+   */
+  int count() const { return count_; }
+
+  /**
+   * @brief Gets the number of indices, active or not.
+   *
+   * @return int.
+   */
+  int size() const { return size_; }
+
+private:
+  int size_;
+  int count_;
+  // bit i of word i / 64 is set if i is active
+  std::vector<std::uint64_t> bits_;
+};
+
+} // namespace logical_solver
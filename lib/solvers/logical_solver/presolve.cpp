@@ -1,5 +1,8 @@
 #include "presolve.hpp"
 #include <iostream>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
 
 namespace logical_solver{
 
@@ -20,32 +23,117 @@ namespace logical_solver{
     reduced_to_empty_(false),
     infeasible_(false),
     infeasible_by_PR_(false),
+    overflow_(false),
     unsatisfied_constraints_(false),
     print_unsatisfied_constraints_(false),
-    presolve_active_rows_count_(constraints_count_),
-    presolve_active_cols_count_(variables_count_)
+    implied_bounds_changed_(false),
+    reduced_solution_set_(false),
+    stats_(),
+    rule_start_rows_count_(0),
+    rule_start_cols_count_(0)
   {
     // Set up constraints lower and upper bounds as 
-    // vector of doubles.
+    // vector of doubles, with the integer sentinels made into
+    // explicit infinities.
     for (std::size_t i=0; i < constraints_count_; ++i) {
-      if (lower_bounds.at(i) == -2147483648) {
-        lower_bounds_.push_back(static_cast<double>(-core::kIntInfinity));
+      if (lower_bounds.at(i) == std::numeric_limits<int>::min()) {
+        lower_bounds_.push_back(-core::kInfinity);
       } else {
         lower_bounds_.push_back(static_cast<double>(lower_bounds.at(i)));
       }
-      upper_bounds_.push_back(static_cast<double>(upper_bounds.at(i)));
+      if (upper_bounds.at(i) == core::kIntInfinity) {
+        upper_bounds_.push_back(core::kInfinity);
+      } else {
+        upper_bounds_.push_back(static_cast<double>(upper_bounds.at(i)));
+      }
     }
+    original_lower_bounds_ = lower_bounds_;
+    original_upper_bounds_ = upper_bounds_;
 
     // Set up active rows and columns arrays as well
     // as implied bounds using problem size and feasible
     // solution vector.
-    presolve_active_rows_.resize(constraints_count_, true);
-    presolve_active_columns_.resize(variables_count_, true);
+    presolve_active_rows_.reset(constraints_count_, true);
+    presolve_active_columns_.reset(variables_count_, true);
+    postsolve_active_rows_.reset(constraints_count_, false);
+    postsolve_active_cols_.reset(variables_count_, false);
     inequality_singletons_ = {};
 
-    implied_lower_bounds_.resize(variables_count_, -core::kIntInfinity);
-    implied_upper_bounds_.resize(variables_count_, core::kIntInfinity);
+    implied_lower_bounds_.resize(variables_count_, -core::kInfinity);
+    implied_upper_bounds_.resize(variables_count_, core::kInfinity);
     feasible_solution_.resize(variables_count_, -999);
+
+    // Every rule removes at least one row or column, which bounds
+    // the number of log entries.
+    int max_log_entries = constraints_count_ + variables_count_;
+    log_rule_ids_.reserve(max_log_entries);
+    log_row_indices_.reserve(max_log_entries);
+    log_col_indices_.reserve(max_log_entries);
+    log_dependancies_offsets_.reserve(max_log_entries);
+    log_values_offsets_.reserve(max_log_entries);
+
+    stats_.rule_stats.resize(core::kNumPresolveRules, core::PresolveRuleStats());
+  }
+
+  void Presolve::logRule(
+    const int row_index, const int col_index,
+    const core::PresolveRulesIds rule_id
+  ) {
+    log_rule_ids_.push_back(static_cast<int>(rule_id));
+    log_row_indices_.push_back(row_index);
+    log_col_indices_.push_back(col_index);
+    log_dependancies_offsets_.push_back(log_dependancies_.size());
+    log_values_offsets_.push_back(log_values_.size());
+  }
+
+  int Presolve::getLogDependanciesCount(const int log_index) {
+    int end = log_index + 1 < log_rule_ids_.size() ?
+      log_dependancies_offsets_.at(log_index + 1) : log_dependancies_.size();
+    return end - log_dependancies_offsets_.at(log_index);
+  }
+
+  int Presolve::getLogDependancy(const int log_index, const int k) {
+    return log_dependancies_.at(log_dependancies_offsets_.at(log_index) + k);
+  }
+
+  double Presolve::getLogValue(const int log_index, const int k) {
+    return log_values_.at(log_values_offsets_.at(log_index) + k);
+  }
+
+  void Presolve::truncateLog(const int entries_count) {
+    if (entries_count >= log_rule_ids_.size()) {return;}
+    log_dependancies_.resize(log_dependancies_offsets_.at(entries_count));
+    log_values_.resize(log_values_offsets_.at(entries_count));
+    log_rule_ids_.resize(entries_count);
+    log_row_indices_.resize(entries_count);
+    log_col_indices_.resize(entries_count);
+    log_dependancies_offsets_.resize(entries_count);
+    log_values_offsets_.resize(entries_count);
+  }
+
+  std::uint64_t Presolve::getElapsedNanos(
+    const std::chrono::steady_clock::time_point start_time
+  ) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_time
+    ).count();
+  }
+
+  void Presolve::startRule() {
+    rule_start_rows_count_ = presolve_active_rows_.count();
+    rule_start_cols_count_ = presolve_active_columns_.count();
+    rule_start_time_ = std::chrono::steady_clock::now();
+  }
+
+  void Presolve::endRule(const core::PresolveRulesIds rule_id) {
+    core::PresolveRuleStats &rule_stats =
+      stats_.rule_stats.at(static_cast<int>(rule_id));
+    rule_stats.time_nanos += getElapsedNanos(rule_start_time_);
+    rule_stats.num_applications += 1;
+    rule_stats.num_rows_removed +=
+      rule_start_rows_count_ - presolve_active_rows_.count();
+    rule_stats.num_cols_removed +=
+      rule_start_cols_count_ - presolve_active_columns_.count();
   }
 
   void Presolve::getRowsAndColsNonZeros() {
@@ -54,27 +142,142 @@ namespace logical_solver{
     rows_non_zero_variables_.resize(constraints_count_, {});
     cols_non_zeros_indices_.resize(variables_count_, {});
 
-    for (std::size_t i = 0; i < constraints_count_; ++i) {
-      if (presolve_active_rows_.at(i)) {
+    // Only visit the active rows and columns, in order.
+    for (int i = presolve_active_rows_.next(0); i < constraints_count_;
+         i = presolve_active_rows_.next(i + 1)) {
+      for (int j = presolve_active_columns_.next(0); j < variables_count_;
+           j = presolve_active_columns_.next(j + 1)) {
+        if (problem_matrix_.at(i).at(j) != 0) {
+          rows_non_zero_variables_.at(i).push_back(j);
+          cols_non_zeros_indices_.at(j).push_back(i);
+        }
+      }
+    }
+  }
 
-        for (std::size_t j = 0; j < variables_count_; ++j) {
-          if (presolve_active_columns_.at(j)) {
+  bool Presolve::isInfinite(const double value) const {
+    return std::isinf(value);
+  }
 
-            if (problem_matrix_.at(i).at(j) != 0) {
-              rows_non_zero_variables_.at(i).push_back(j);
-              cols_non_zeros_indices_.at(j).push_back(i);
-            }
-          }
+  bool Presolve::isExact(const double value) const {
+    return std::fabs(value) <= core::kMaxExactInteger;
+  }
+
+  void Presolve::checkRowBoundsOverflow(const int row_index) {
+    if ((!isInfinite(lower_bounds_.at(row_index)) && !isExact(lower_bounds_.at(row_index))) ||
+        (!isInfinite(upper_bounds_.at(row_index)) && !isExact(upper_bounds_.at(row_index)))) {
+      overflow_ = true;
+    }
+  }
+
+  void Presolve::updateRowActivity(
+    const int row_index, const int coefficient,
+    const double lower_bound, const double upper_bound, const int sign
+  ) {
+    if (coefficient == 0) {return;}
+
+    // With a positive coefficient the lower bound gives the minimum
+    // activity and the upper bound the maximum, the other way
+    // round with a negative coefficient.
+    double min_bound = coefficient > 0 ? lower_bound : upper_bound;
+    double max_bound = coefficient > 0 ? upper_bound : lower_bound;
+
+    if (isInfinite(min_bound)) {
+      min_activities_inf_count_.at(row_index) += sign;
+    } else {
+      min_activities_.at(row_index) += sign * coefficient * min_bound;
+    }
+    if (isInfinite(max_bound)) {
+      max_activities_inf_count_.at(row_index) += sign;
+    } else {
+      max_activities_.at(row_index) += sign * coefficient * max_bound;
+    }
+  }
+
+  void Presolve::computeRowActivities() {
+    min_activities_.assign(constraints_count_, 0);
+    max_activities_.assign(constraints_count_, 0);
+    min_activities_inf_count_.assign(constraints_count_, 0);
+    max_activities_inf_count_.assign(constraints_count_, 0);
+
+    for (std::size_t i = 0; i < constraints_count_; ++i) {
+      for (int j = presolve_active_columns_.next(0); j < variables_count_;
+           j = presolve_active_columns_.next(j + 1)) {
+        int coefficient = problem_matrix_.at(i).at(j);
+        if (coefficient != 0) {
+          updateRowActivity(
+            i, coefficient, implied_lower_bounds_.at(j),
+            implied_upper_bounds_.at(j), 1
+          );
         }
       }
     }
   }
 
+  void Presolve::updateImpliedBounds(
+    const int col_index, const double lower_bound, const double upper_bound
+  ) {
+    // Swap the old contribution of the variable for the new one in
+    // every active row containing it.
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (presolve_active_rows_.isActive(i)) {
+        int coefficient = problem_matrix_.at(i).at(col_index);
+        updateRowActivity(
+          i, coefficient, implied_lower_bounds_.at(col_index),
+          implied_upper_bounds_.at(col_index), -1
+        );
+        updateRowActivity(i, coefficient, lower_bound, upper_bound, 1);
+      }
+    }
+    implied_lower_bounds_.at(col_index) = lower_bound;
+    implied_upper_bounds_.at(col_index) = upper_bound;
+  }
+
+  void Presolve::tightenImpliedBounds(
+    const int col_index, const double lower_bound, const double upper_bound
+  ) {
+    double old_lower_bound = implied_lower_bounds_.at(col_index);
+    double old_upper_bound = implied_upper_bounds_.at(col_index);
+    double new_lower_bound = old_lower_bound;
+    double new_upper_bound = old_upper_bound;
+
+    // Only accept bounds which are finite and tighter by more than
+    // the tolerance, so that propagation cannot go on forever with
+    // ever smaller improvements. Bounds past the exact integer range
+    // are dropped, which only relaxes the problem.
+    if (isExact(lower_bound) && (isInfinite(old_lower_bound) ||
+        lower_bound > old_lower_bound + core::kFeasibilityTolerance *
+        (1 + std::fabs(old_lower_bound)))) {
+      new_lower_bound = lower_bound;
+    }
+    if (isExact(upper_bound) && (isInfinite(old_upper_bound) ||
+        upper_bound < old_upper_bound - core::kFeasibilityTolerance *
+        (1 + std::fabs(old_upper_bound)))) {
+      new_upper_bound = upper_bound;
+    }
+    if (new_lower_bound == old_lower_bound &&
+        new_upper_bound == old_upper_bound) {
+      return;
+    }
+
+    if (new_lower_bound > new_upper_bound) {
+      if (new_lower_bound - new_upper_bound > core::kFeasibilityTolerance *
+          (1 + std::fabs(new_lower_bound))) {
+        infeasible_ = true;
+        return;
+      }
+      // Bounds crossing within the tolerance fix the variable.
+      new_upper_bound = new_lower_bound;
+    }
+    updateImpliedBounds(col_index, new_lower_bound, new_upper_bound);
+    implied_bounds_changed_ = true;
+  }
+
   double Presolve::getFeasibleValueCalculationBound(const int row_index) {
     double lower_bound = lower_bounds_.at(row_index);
     double upper_bound = upper_bounds_.at(row_index);
 
-    if (lower_bound != -core::kIntInfinity) {
+    if (!isInfinite(lower_bound)) {
       return lower_bound;
     }
     return upper_bound;
@@ -109,11 +312,12 @@ namespace logical_solver{
   ) {
     double dependancy_feasible_value = feasible_solution_.at(dependancy_col_index);
 
-    for (std::size_t i; i < constraints_count_; ++i) {
-      if (problem_matrix_.at(i).at(dependancy_col_index) != 0 && postsolve_active_rows_.at(i)) {
-        feasible_solution_.at(dependancy_col_index) = dependancy_feasible_value;
+    for (int i = postsolve_active_rows_.next(0); i < constraints_count_;
+         i = postsolve_active_rows_.next(i + 1)) {
+      if (problem_matrix_.at(i).at(dependancy_col_index) != 0) {
+        setPostsolveValue(dependancy_col_index, dependancy_new_feasible_value);
         bool is_constraint_satisfied = checkConstraint(i, 0);
-        feasible_solution_.at(dependancy_col_index) = dependancy_feasible_value;
+        setPostsolveValue(dependancy_col_index, dependancy_feasible_value);
 
         if (!is_constraint_satisfied) {return false;}
       }
@@ -122,12 +326,19 @@ namespace logical_solver{
     return true;
   }
 
-  int Presolve::getVariableFeasibleValueIP(
+  std::optional<int> Presolve::getVariableFeasibleValueIP(
     const int row_index, const int col_index, 
     const int variable_coefficient, const double constraint_RHS
   ) {
+    // Values past the int range cannot be returned, give up on the
+    // problem rather than report it infeasible.
+    if (std::fabs(constraint_RHS/variable_coefficient) >= core::kIntInfinity) {
+      overflow_ = true;
+      return std::nullopt;
+    }
+
     // Check if RHS/coeff is not an integer
-    if (static_cast<int>(constraint_RHS) % variable_coefficient != 0) {
+    if (std::fmod(constraint_RHS, variable_coefficient) != 0) {
       // If inequality, check if rounding satisfies implied bounds.
       if (row_index < inequalities_count_) {
         int feasible_value;
@@ -154,12 +365,18 @@ namespace logical_solver{
         double dependancy_potential_value = (variable_coefficient - lower_bounds_.at(row_index))/problem_matrix_.at(row_index).at(dependancy_index);
         if (dependancy_potential_value == floor(dependancy_potential_value)) {
           if (checkDependancyIP(dependancy_potential_value, dependancy_index)) {
-            feasible_solution_.at(dependancy_index) = dependancy_potential_value;
+            // Row singletons are also solved in presolve, before
+            // any column has a postsolve value.
+            if (postsolve_active_cols_.isActive(dependancy_index)) {
+              setPostsolveValue(dependancy_index, dependancy_potential_value);
+            } else {
+              feasible_solution_.at(dependancy_index) = dependancy_potential_value;
+            }
             return 1;
           }
         }
       }
-      return core::kIntInfinity;
+      return std::nullopt;
     }
     // If RHS/coeff is integer, calculate it and check if 
     // implied bounds satisfied.
@@ -167,7 +384,7 @@ namespace logical_solver{
     if (checkVariableImpliedBounds(col_index, feasible_value)) {
       return feasible_value;
     }
-    return core::kIntInfinity;
+    return std::nullopt;
   }
 
   bool Presolve::isFeasibleSolutionInteger() {
@@ -183,47 +400,36 @@ namespace logical_solver{
   bool Presolve::checkIsRowFree(const int row_index) {
     if (solve_ip_) {
       if (lower_bounds_.at(row_index) == -2147483646.000000) {
-        lower_bounds_.at(row_index) = -core::kIntInfinity;
+        lower_bounds_.at(row_index) = -core::kInfinity;
       }
     }
-    if (lower_bounds_.at(row_index) == -core::kIntInfinity && upper_bounds_.at(row_index) == core::kIntInfinity) {
+    if (isInfinite(lower_bounds_.at(row_index)) && isInfinite(upper_bounds_.at(row_index))) {
       return true;
     }
     return false;
   }
 
   void Presolve::updateStateFreeRow(const int row_index) {
-    presolve_active_rows_.at(row_index) = false;
-    presolve_active_rows_count_ -= 1;
+    presolve_active_rows_.deactivate(row_index);
 
     // Update presolve stack.
-    struct presolve_log log = {
-      row_index, -1, 
-      static_cast<int>(core::PresolveRulesIds::freeRowId)
-    };
-    presolve_stack_.push(log);
+    logRule(row_index, -1, core::PresolveRulesIds::freeRowId);
   }
 
   void Presolve::applyFreeRowPostsolve(
     const int row_index
   ) {
-    postsolve_active_rows_.at(row_index) = true;
+    postsolve_active_rows_.activate(row_index);
   }
 
   void Presolve::updateStateRowAndColSingleton(
     const int row_index, const int col_index
   ) {
-    presolve_active_rows_.at(row_index) = false;
-    presolve_active_columns_.at(col_index) = false;
-    presolve_active_rows_count_ -= 1;
-    presolve_active_cols_count_ -= 1;
+    presolve_active_rows_.deactivate(row_index);
+    presolve_active_columns_.deactivate(col_index);
 
     // Update presolve stack.
-    struct presolve_log log = {
-      row_index, col_index, 
-      static_cast<int>(core::PresolveRulesIds::rowAndColSingletonId)
-    };
-    presolve_stack_.push(log);
+    logRule(row_index, col_index, core::PresolveRulesIds::rowAndColSingletonId);
   }
 
   void Presolve::applyRowAndColSingletonPostsolve(
@@ -233,7 +439,7 @@ namespace logical_solver{
     double feasibleValueCalculationBound = getFeasibleValueCalculationBound(
       row_index
     );
-    double feasible_value;
+    std::optional<double> feasible_value;
 
     if (solve_ip_) {
       feasible_value = getVariableFeasibleValueIP(
@@ -242,17 +448,21 @@ namespace logical_solver{
       );
     } else {
       feasible_value = feasibleValueCalculationBound/variable_coeff;
+      // An inequality stays satisfied when the variable moves
+      // further into it, so respect its implied bounds.
+      if (row_index < inequalities_count_) {
+        feasible_value = clampToImpliedBounds(col_index, *feasible_value);
+      }
     }
-    if (feasible_value == core::kIntInfinity) {infeasible_ = true;}
+    if (!feasible_value) {infeasible_ = !overflow_;}
     else {
-      feasible_solution_.at(col_index) = feasible_value;
-      postsolve_active_cols_.at(col_index) = true;
+      setPostsolveValue(col_index, *feasible_value);
       // Check if we have found feasible values for all variables in the 
       // row. If so, check if the row (constraint) is satisfied, and if 
       // so turn on row in postsolve.
       if (isRowActivePostsolve(row_index)) {
         if (checkConstraint(row_index, static_cast<int>(core::PresolveRulesIds::rowAndColSingletonId))) {
-          postsolve_active_rows_.at(row_index) = true;
+          postsolve_active_rows_.activate(row_index);
         }
       }
     }
@@ -262,11 +472,11 @@ namespace logical_solver{
     const int row_index, const int col_index
   ) {
     int variable_coefficient = problem_matrix_.at(row_index).at(col_index);
-    int RHS = lower_bounds_.at(row_index);
+    double RHS = lower_bounds_.at(row_index);
     // In row singleton equality, if we are solving the ip,
     // we check it is feasible in presolve already so that we 
     // do not continue the process of it is not feasible.
-    double variable_value;
+    std::optional<double> variable_value;
     if (solve_ip_) {
       variable_value = getVariableFeasibleValueIP(
         row_index, col_index, variable_coefficient, RHS
@@ -274,49 +484,49 @@ namespace logical_solver{
     } else {
       variable_value = static_cast<double>(RHS)/variable_coefficient;
     } 
-    if (variable_value != core::kIntInfinity) {
-      presolve_active_rows_.at(row_index) = false;
-      presolve_active_rows_count_ -= 1;
-      implied_lower_bounds_.at(col_index) = variable_value;
-      implied_upper_bounds_.at(col_index) = variable_value;
+    if (variable_value) {
+      presolve_active_rows_.deactivate(row_index);
+      // Fixing the variable outside its implied bounds sets the
+      // problem to infeasible.
+      tightenImpliedBounds(col_index, *variable_value, *variable_value);
 
       // Update presolve stack.
-      struct presolve_log log = {
-        row_index, col_index, 
-        static_cast<int>(core::PresolveRulesIds::rowSingletonId)
-      };
-      presolve_stack_.push(log);
+      logRule(row_index, col_index, core::PresolveRulesIds::rowSingletonId);
     } else {
-      infeasible_ = true;
+      infeasible_ = !overflow_;
     }
   }
 
   void Presolve::updateStateRowSingletonInequality(
     const int row_index, const int col_index
   ) {
-    // Get the implied bound by divinding the lower bound on the
+    // Get the implied bounds by divinding the bounds on the
     // constraint by the coefficient.
     int variable_coefficient = problem_matrix_.at(row_index).at(col_index);
+    double row_lower_bound = lower_bounds_.at(row_index);
+    double row_upper_bound = upper_bounds_.at(row_index);
 
+    double implied_lower_bound = -core::kInfinity;
+    double implied_upper_bound = core::kInfinity;
     if (variable_coefficient < 0) {
-      // If coefficient negative, upper bound becomes 
-      // lower bound divided by coefficient, and we use floor
-      // to make sure that the bound is met in integer arithmetic.
-      int implied_bound = std::floor(
-        float(lower_bounds_.at(row_index))/float(variable_coefficient)
-      );
-      implied_lower_bounds_.at(col_index) = -implied_upper_bounds_.at(col_index);
-      implied_upper_bounds_.at(col_index) = implied_bound;
+      // If coefficient negative, the lower bound on the constraint
+      // gives an upper bound on the variable and vice versa.
+      std::swap(row_lower_bound, row_upper_bound);
+    }
+    if (!isInfinite(row_lower_bound)) {
+      implied_lower_bound = row_lower_bound/variable_coefficient;
+    }
+    if (!isInfinite(row_upper_bound)) {
+      implied_upper_bound = row_upper_bound/variable_coefficient;
+    }
 
-    } else {
-      // If coefficient not negative, lower bound becomes lower
-      // bound divided by the coefficient and we use ceil to make
-      // bound is met in integer arithmetic.
-      int implied_bound = std::ceil(
-        float(lower_bounds_.at(row_index))/float(variable_coefficient)
-      );
-      implied_lower_bounds_.at(col_index) = implied_bound;
+    // If solving the ip, round the bounds inwards to make sure
+    // they are met in integer arithmetic.
+    if (solve_ip_) {
+      implied_lower_bound = std::ceil(implied_lower_bound);
+      implied_upper_bound = std::floor(implied_upper_bound);
     }
+    tightenImpliedBounds(col_index, implied_lower_bound, implied_upper_bound);
   }
 
   void Presolve::applyRowSingletonPostsolve(const int row_index){
@@ -327,7 +537,7 @@ namespace logical_solver{
     // constraints checks.
     if (isRowActivePostsolve(row_index)) {
       if (checkConstraint(row_index, static_cast<int>(core::PresolveRulesIds::rowSingletonId))) {
-        postsolve_active_rows_.at(row_index) = true;
+        postsolve_active_rows_.activate(row_index);
       }
     }
   }
@@ -344,7 +554,10 @@ namespace logical_solver{
     if (row1_first_non_zero_col != row2_first_non_zero_col) {
       return false;
     }
-    double ratio = static_cast<double>(problem_matrix_.at(row1_index).at(row1_first_non_zero_col))/problem_matrix_.at(row2_index).at(row2_first_non_zero_col);
+    // The rows are parallel if a_1j a_20 = a_2j a_10 in every column,
+    // which is exact in 64 bit integers unlike comparing ratios.
+    long long row1_first_coefficient = problem_matrix_.at(row1_index).at(row1_first_non_zero_col);
+    long long row2_first_coefficient = problem_matrix_.at(row2_index).at(row2_first_non_zero_col);
 
     for (std::size_t j = 1; j < rows_non_zero_variables_.at(row1_index).size(); ++j) {
       int row1_non_zero_col = rows_non_zero_variables_.at(row1_index).at(j);
@@ -354,9 +567,10 @@ namespace logical_solver{
         return false;
       }
 
-      double ratio_new = static_cast<double>(problem_matrix_.at(row1_index).at(row1_non_zero_col))/problem_matrix_.at(row2_index).at(row2_non_zero_col);
-      if (ratio != ratio_new) {return false;}
-      ratio = ratio_new;
+      if (problem_matrix_.at(row1_index).at(row1_non_zero_col) * row2_first_coefficient !=
+          problem_matrix_.at(row2_index).at(row2_non_zero_col) * row1_first_coefficient) {
+        return false;
+      }
     }
 
     return true;
@@ -365,7 +579,8 @@ namespace logical_solver{
   int Presolve::getParallelRow(const int row_index, const int start) {
     if (row_index == start) {return -1;}
     
-    for (std::size_t k = start; k < row_index; ++k) {
+    for (int k = presolve_active_rows_.next(start); k < row_index;
+         k = presolve_active_rows_.next(k + 1)) {
       if (checkAreRowsParallel(row_index, k)) {return k;}
     }
 
@@ -392,113 +607,99 @@ namespace logical_solver{
     return {row, parallel_row};
   }
 
-  bool Presolve::checkAreParallelRowsFeasible(
-    const int small_row_index,
-    const int large_to_small_ratio,
-    const double large_lower_bound_by_ratio
-  ){
-    // If we are dealing with an equality, check if the bounds
-    // are also multiples of eachother and if they aren't
-    // then the system is not feasible.
-    if (small_row_index >= inequalities_count_) {
-      if (large_lower_bound_by_ratio != lower_bounds_.at(small_row_index)) {
-        return false;
-      }
+  std::vector<double> Presolve::getParallelRowBoundsOnSmallRow(
+    const int large_row_index,
+    const double large_to_small_ratio
+  ) {
+    // Dividing the large row by the ratio turns it into the small
+    // row, so its bounds divided by the ratio bound the small row.
+    // A negative ratio swaps them round.
+    double large_row_lower_bound = lower_bounds_.at(large_row_index);
+    double large_row_upper_bound = upper_bounds_.at(large_row_index);
+    double lower_bound = -core::kInfinity;
+    double upper_bound = core::kInfinity;
+    if (!isInfinite(large_row_lower_bound)) {
+      if (large_to_small_ratio > 0) {lower_bound = large_row_lower_bound/large_to_small_ratio;}
+      else {upper_bound = large_row_lower_bound/large_to_small_ratio;}
     }
-    // If we have one row of each sign, we now have to check feasibility
-    // for inequalities.
-    if (large_to_small_ratio < 0) {
-      // large bound by ratio (rounded down to ensure feasibility for
-      // integers if solving ip) now becomes an upper bound of the 
-      // small inequality. Thus, if it is smaller than the small row's 
-      // bound, the problem is infeasible.
-      if (solve_ip_) {
-        if (std::floor(large_lower_bound_by_ratio) < lower_bounds_.at(small_row_index)) {
-          return false;
-        }
-      } else {
-        if (large_lower_bound_by_ratio < lower_bounds_.at(small_row_index)) {
-          return false;
-        }
-      }
+    if (!isInfinite(large_row_upper_bound)) {
+      if (large_to_small_ratio > 0) {upper_bound = large_row_upper_bound/large_to_small_ratio;}
+      else {lower_bound = large_row_upper_bound/large_to_small_ratio;}
     }
-    return true;
 
+    // If solving the ip, round the bounds inwards to make sure
+    // they are met in integer arithmetic.
+    if (solve_ip_) {
+      if (!isInfinite(lower_bound)) {lower_bound = std::ceil(lower_bound - core::kFeasibilityTolerance);}
+      if (!isInfinite(upper_bound)) {upper_bound = std::floor(upper_bound + core::kFeasibilityTolerance);}
+    }
+    return {lower_bound, upper_bound};
+  }
+
+  bool Presolve::checkAreParallelRowsFeasible(
+    const int small_row_index,
+    const int large_row_index,
+    const double large_to_small_ratio
+  ){
+    // The rows are feasible together if the bounds the large row puts
+    // on the small row overlap with the small row's own bounds.
+    std::vector<double> bounds = getParallelRowBoundsOnSmallRow(
+      large_row_index, large_to_small_ratio
+    );
+    double lower_bound = std::max(bounds.at(0), lower_bounds_.at(small_row_index));
+    double upper_bound = std::min(bounds.at(1), upper_bounds_.at(small_row_index));
+    if (isInfinite(lower_bound) || isInfinite(upper_bound)) {return true;}
+    return lower_bound - upper_bound <= core::kFeasibilityTolerance*(1 + std::fabs(lower_bound));
   }
 
   void Presolve::updateStateParallelRow(
     const int small_row_index, 
     const int large_row_index,
-    const double large_to_small_ratio,
-    const double large_lower_bound_by_ratio
+    const double large_to_small_ratio
   ) {
     // turn off large row and log into stack
-    presolve_active_rows_.at(large_row_index) = false;
-    presolve_active_rows_count_ -= 1;
-    struct presolve_log log = {
-      large_row_index, -1, 
-      static_cast<int>(core::PresolveRulesIds::parallelRowId)
-    };
-    presolve_stack_.push(log);
-
-    // if we have an inequality, update the bound on the small row 
-    // to ensure that both are satisfied.
+    presolve_active_rows_.deactivate(large_row_index);
+    logRule(large_row_index, -1, core::PresolveRulesIds::parallelRowId);
+
+    // Tighten the small row's bounds to the intersection of both rows
+    // so that satisfying it satisfies the large row too. Equalities have
+    // already been checked to agree in checkAreParallelRowsFeasible.
     if (small_row_index < inequalities_count_) {
-      // If we are solving the ip then we have that we 
-      // need to round up the large row's lower bound divided by 
-      // the ratio to ensure that constraints are satisfied when 
-      // restricted to integers.
-      double potential_lower_bound;
-      if (solve_ip_) {potential_lower_bound = std::ceil(large_lower_bound_by_ratio);}
-      else {potential_lower_bound = large_lower_bound_by_ratio;}
-
-      int small_row_lower_bound = lower_bounds_.at(small_row_index);
-
-      if (large_to_small_ratio > 0) {
-        // If the inequalities both have the same sign then we use 
-        // the bound that takes up all the slack.
-        if (small_row_lower_bound > potential_lower_bound) {
-          lower_bounds_.at(small_row_index) = potential_lower_bound;
-        }
-      } else {
-        // If they do not have the same sign, then that means that the 
-        // lower bound of the large one divided by the large 
-        // to small ratio (rounded down if we are solving the ip), 
-        // will have become an upper bound of the small one - if 
-        // this upper bound is smaller than the small one's
-        // lower bound, we will have already deemed the system unfeasible in 
-        // checkAreParallelRowsFeasible.
-        if (solve_ip_) {
-          upper_bounds_.at(small_row_index) = std::floor(large_lower_bound_by_ratio);
-        } else {
-          upper_bounds_.at(small_row_index) = large_lower_bound_by_ratio;
-        }
+      std::vector<double> bounds = getParallelRowBoundsOnSmallRow(
+        large_row_index, large_to_small_ratio
+      );
+      if (bounds.at(0) > lower_bounds_.at(small_row_index)) {
+        lower_bounds_.at(small_row_index) = bounds.at(0);
+      }
+      if (bounds.at(1) < upper_bounds_.at(small_row_index)) {
+        upper_bounds_.at(small_row_index) = bounds.at(1);
       }
+      // Bounds that cross within tolerance describe a single value.
+      if (lower_bounds_.at(small_row_index) > upper_bounds_.at(small_row_index)) {
+        upper_bounds_.at(small_row_index) = lower_bounds_.at(small_row_index);
+      }
+      checkRowBoundsOverflow(small_row_index);
     }
   }
 
   void Presolve::applyParallelRowPostsolve(const int row_index) {
     if (isRowActivePostsolve(row_index)) {
       if (checkConstraint(row_index, static_cast<int>(core::PresolveRulesIds::parallelRowId))) {
-        postsolve_active_rows_.at(row_index) = true;
+        postsolve_active_rows_.activate(row_index);
       }
     }
   }
 
   void Presolve::updateStateEmptyCol(const int col_index) {
-    presolve_active_columns_.at(col_index) = false;
-    presolve_active_cols_count_ -= 1;
+    presolve_active_columns_.deactivate(col_index);
 
-    struct presolve_log log = {
-      -1, col_index, 
-      static_cast<int>(core::PresolveRulesIds::emptyColId)
-    };
-    presolve_stack_.push(log);
+    logRule(-1, col_index, core::PresolveRulesIds::emptyColId);
   }
 
   void Presolve::applyEmptyColPostsolve(const int col_index) {
-    feasible_solution_.at(col_index) = 0;
-    postsolve_active_cols_.at(col_index) = true;
+    // Any value within the implied bounds will do, rows removed
+    // as redundant may rely on them.
+    setPostsolveValue(col_index, clampToImpliedBounds(col_index, 0));
   }
 
   bool Presolve::isFixedCol(const int col_index) {
@@ -509,53 +710,66 @@ namespace logical_solver{
   }
 
   void Presolve::updateStateFixedCol(const int col_index) {
-    int variable_value = implied_lower_bounds_.at(col_index);
-    // Update the lower bound of each constraint that 
-    // contains the variable using the variable value.
+    double variable_value = implied_lower_bounds_.at(col_index);
+    // Update the bounds of each constraint that contains the
+    // variable using the variable value, and take the variable
+    // out of the row activities.
     for (auto&i : cols_non_zeros_indices_.at(col_index)) {
       int coefficient = problem_matrix_.at(i).at(col_index);
-      int lower_bound = lower_bounds_.at(i);
-      lower_bounds_.at(i) = lower_bound - coefficient * variable_value;
+      if (!isInfinite(lower_bounds_.at(i))) {
+        lower_bounds_.at(i) -= coefficient * variable_value;
+      }
+      if (!isInfinite(upper_bounds_.at(i))) {
+        upper_bounds_.at(i) -= coefficient * variable_value;
+      }
+      checkRowBoundsOverflow(i);
+      if (presolve_active_rows_.isActive(i)) {
+        updateRowActivity(
+          i, coefficient, variable_value, variable_value, -1
+        );
+      }
     }
 
-    presolve_active_columns_.at(col_index) = false;
-    presolve_active_cols_count_ -= 1;
+    presolve_active_columns_.deactivate(col_index);
     // Log -1 in row index as not applicable in this 
     // rule.
-    struct presolve_log log = {
-      -1, col_index, 
-      static_cast<int>(core::PresolveRulesIds::fixedColId), 
-      cols_non_zeros_indices_.at(col_index)
-    };
-    presolve_stack_.push(log);
+    logRule(-1, col_index, core::PresolveRulesIds::fixedColId);
+    log_dependancies_.insert(
+      log_dependancies_.end(), cols_non_zeros_indices_.at(col_index).begin(),
+      cols_non_zeros_indices_.at(col_index).end()
+    );
   }
 
   void Presolve::applyFixedColPostsolve(
-    const int col_index, const std::vector<int> col_non_zeros
+    const int col_index, const int log_index
   ) {
     // In postsolve we know that the feasible value 
     // is feasible because when updating the implied 
     // bounds in presolve we check that the implied 
     // bounds we get are integers.
-    int feasible_value = implied_lower_bounds_.at(col_index);
+    double feasible_value = implied_lower_bounds_.at(col_index);
 
-    // Re-update the lower bound of each constraint that 
+    // Re-update the bounds of each constraint that 
     // contained the variable at the time it was identified 
     // as fixed using the variable value.
-    for (auto&i : col_non_zeros) {
+    for (int k = 0; k < getLogDependanciesCount(log_index); ++k) {
+      int i = getLogDependancy(log_index, k);
       int coefficient = problem_matrix_.at(i).at(col_index);
-      int lower_bound = lower_bounds_.at(i);
-      lower_bounds_.at(i) = lower_bound + coefficient * feasible_value;
+      if (!isInfinite(lower_bounds_.at(i))) {
+        lower_bounds_.at(i) += coefficient * feasible_value;
+      }
+      if (!isInfinite(upper_bounds_.at(i))) {
+        upper_bounds_.at(i) += coefficient * feasible_value;
+      }
     }
 
-    postsolve_active_cols_.at(col_index) = true;
-    feasible_solution_.at(col_index) = feasible_value;
+    setPostsolveValue(col_index, feasible_value);
   }
 
   bool Presolve::isFreeColSubstitution(
     const int row_index, const int col_index
   ) {
-    if (implied_lower_bounds_.at(col_index) == -core::kIntInfinity && implied_upper_bounds_.at(col_index) == core::kIntInfinity) {
+    if (isInfinite(implied_lower_bounds_.at(col_index)) && isInfinite(implied_upper_bounds_.at(col_index))) {
       return true;
     }
     return false;
@@ -565,40 +779,23 @@ namespace logical_solver{
     int row_index, int col_index
   ) {
     // Turn off row and col
-    presolve_active_rows_.at(row_index) = false;
-    presolve_active_columns_.at(col_index) = false;
-    presolve_active_rows_count_ -= 1;
-    presolve_active_cols_count_ -= 1;
+    presolve_active_rows_.deactivate(row_index);
+    presolve_active_columns_.deactivate(col_index);
 
     // Update presolve stack.
-    struct presolve_log log = {
-      row_index, col_index, 
-      static_cast<int>(core::PresolveRulesIds::freeColSubsId)
-    };
-    presolve_stack_.push(log);
+    logRule(row_index, col_index, core::PresolveRulesIds::freeColSubsId);
   }
 
   double Presolve::getFreeColSubstitutionSumOfDependancies(
     const int row_index, const int col_index
   ) {
-    double sum_of_dependancies = 0;
-
-    for (std::size_t j = 0; j < variables_count_; ++j) {
-      // If it is not the singleton column, check if the coefficient
-      // in the problem is non-zero, and if it isn't if a feasible value
-      // has been found update sum of dependancies, and it not return 
-      // core::kIntInfinity.
-      if (j != col_index) {
-        int col_coefficient = problem_matrix_.at(row_index).at(j);
-
-        if (col_coefficient != 0) {
-          if (postsolve_active_cols_.at(j))  {
-            sum_of_dependancies += col_coefficient*feasible_solution_.at(j);
-          } else {
-            return core::kIntInfinity;
-          }
-        }
-      }
+    // The running activity covers the columns with a value, leave
+    // out the singleton column. Postsolve runs in reverse, so columns
+    // without a value yet were removed before the substitution and
+    // their contribution is already in the row bounds.
+    double sum_of_dependancies = postsolve_row_activities_.at(row_index);
+    if (postsolve_active_cols_.isActive(col_index)) {
+      sum_of_dependancies -= problem_matrix_.at(row_index).at(col_index)*feasible_solution_.at(col_index);
     }
     return sum_of_dependancies;
   }
@@ -615,137 +812,846 @@ namespace logical_solver{
       row_index
     );
 
-    if (sum_of_dependancies != core::kIntInfinity) {
-      double RHS = feasibleValueCalculationBound - sum_of_dependancies;
-      int variable_coefficient = problem_matrix_.at(row_index).at(col_index);
-      double feasible_value;
+    double RHS = feasibleValueCalculationBound - sum_of_dependancies;
+    int variable_coefficient = problem_matrix_.at(row_index).at(col_index);
+    std::optional<double> feasible_value;
+
+    if (solve_ip_) {
+      feasible_value = getVariableFeasibleValueIP(
+        row_index, col_index, variable_coefficient, RHS
+      );
+    } else {
+      feasible_value = RHS/variable_coefficient;
+    }
+
+    if (!feasible_value) {infeasible_ = !overflow_;}
+    else {
+      setPostsolveValue(col_index, *feasible_value);
+      // Check if we have found feasible values for all variables in the 
+      // row. If so, check if the row (constraint) is satisfied, and if 
+      // so turn on row in postsolve.
+      if (isRowActivePostsolve(row_index)) {
+        if (checkConstraint(row_index, 6)) {
+          postsolve_active_rows_.activate(row_index);
+        }
+      }
+    }
+  }
+
+  void Presolve::updateStateEmptyRow(const int row_index) {
+    // With no variables left the row activity is zero.
+    double tolerance = core::kFeasibilityTolerance;
+    if (lower_bounds_.at(row_index) > tolerance ||
+        upper_bounds_.at(row_index) < -tolerance) {
+      infeasible_ = true;
+      return;
+    }
+    presolve_active_rows_.deactivate(row_index);
+
+    logRule(row_index, -1, core::PresolveRulesIds::emptyRowId);
+  }
+
+  bool Presolve::isRowRedundant(const int row_index) {
+    bool is_lower_bound_redundant = isInfinite(lower_bounds_.at(row_index)) ||
+      (min_activities_inf_count_.at(row_index) == 0 &&
+       min_activities_.at(row_index) >= lower_bounds_.at(row_index));
+    bool is_upper_bound_redundant = isInfinite(upper_bounds_.at(row_index)) ||
+      (max_activities_inf_count_.at(row_index) == 0 &&
+       max_activities_.at(row_index) <= upper_bounds_.at(row_index));
+    return is_lower_bound_redundant && is_upper_bound_redundant;
+  }
+
+  void Presolve::updateStateRedundantRow(const int row_index) {
+    presolve_active_rows_.deactivate(row_index);
+
+    logRule(row_index, -1, core::PresolveRulesIds::redundantRowId);
+  }
+
+  void Presolve::updateStateForcingRow(
+    const int row_index, const bool at_max_activity
+  ) {
+    // Fix every variable at the bound which gives the maximum
+    // (or minimum) activity. All of these bounds are finite.
+    for (auto&j : rows_non_zero_variables_.at(row_index)) {
+      if (!presolve_active_columns_.isActive(j)) {continue;}
+      int coefficient = problem_matrix_.at(row_index).at(j);
+      double value = (coefficient > 0) == at_max_activity ?
+        implied_upper_bounds_.at(j) : implied_lower_bounds_.at(j);
+      tightenImpliedBounds(j, value, value);
+    }
+
+    presolve_active_rows_.deactivate(row_index);
+
+    logRule(row_index, -1, core::PresolveRulesIds::forcingRowId);
+  }
+
+  void Presolve::propagateRowBounds(const int row_index) {
+    double row_lower_bound = lower_bounds_.at(row_index);
+    double row_upper_bound = upper_bounds_.at(row_index);
+
+    for (auto&j : rows_non_zero_variables_.at(row_index)) {
+      if (!presolve_active_columns_.isActive(j)) {continue;}
+      // Bounds on column singletons are only implied by this row,
+      // keep them free for free column substitution.
+      if (cols_non_zeros_indices_.at(j).size() == 1) {continue;}
+
+      int coefficient = problem_matrix_.at(row_index).at(j);
+      double min_bound = coefficient > 0 ?
+        implied_lower_bounds_.at(j) : implied_upper_bounds_.at(j);
+      double max_bound = coefficient > 0 ?
+        implied_upper_bounds_.at(j) : implied_lower_bounds_.at(j);
+
+      // Activity of the rest of the row, which is only finite if
+      // no other variable contributes an infinite bound.
+      double residual_max = core::kInfinity;
+      int max_inf_count = max_activities_inf_count_.at(row_index);
+      if (max_inf_count == 0) {
+        residual_max = max_activities_.at(row_index) - coefficient * max_bound;
+      } else if (max_inf_count == 1 && isInfinite(max_bound)) {
+        residual_max = max_activities_.at(row_index);
+      }
+      double residual_min = -core::kInfinity;
+      int min_inf_count = min_activities_inf_count_.at(row_index);
+      if (min_inf_count == 0) {
+        residual_min = min_activities_.at(row_index) - coefficient * min_bound;
+      } else if (min_inf_count == 1 && isInfinite(min_bound)) {
+        residual_min = min_activities_.at(row_index);
+      }
+
+      // coefficient * x_j >= row lower bound - residual max and
+      // coefficient * x_j <= row upper bound - residual min.
+      double activity_lower_bound = -core::kInfinity;
+      double activity_upper_bound = core::kInfinity;
+      if (!isInfinite(row_lower_bound) && !isInfinite(residual_max)) {
+        activity_lower_bound = row_lower_bound - residual_max;
+      }
+      if (!isInfinite(row_upper_bound) && !isInfinite(residual_min)) {
+        activity_upper_bound = row_upper_bound - residual_min;
+      }
+      if (isInfinite(activity_lower_bound) &&
+          isInfinite(activity_upper_bound)) {
+        continue;
+      }
+
+      double implied_lower_bound = -core::kInfinity;
+      double implied_upper_bound = core::kInfinity;
+      if (coefficient > 0) {
+        if (!isInfinite(activity_lower_bound)) {
+          implied_lower_bound = activity_lower_bound/coefficient;
+        }
+        if (!isInfinite(activity_upper_bound)) {
+          implied_upper_bound = activity_upper_bound/coefficient;
+        }
+      } else {
+        if (!isInfinite(activity_upper_bound)) {
+          implied_lower_bound = activity_upper_bound/coefficient;
+        }
+        if (!isInfinite(activity_lower_bound)) {
+          implied_upper_bound = activity_lower_bound/coefficient;
+        }
+      }
 
       if (solve_ip_) {
-        feasible_value = getVariableFeasibleValueIP(
-          row_index, col_index, variable_coefficient, RHS
+        implied_lower_bound = std::ceil(
+          implied_lower_bound - core::kFeasibilityTolerance
+        );
+        implied_upper_bound = std::floor(
+          implied_upper_bound + core::kFeasibilityTolerance
+        );
+      }
+
+      // Ignore small improvements, which otherwise creep towards
+      // a limit over many iterations.
+      double old_lower_bound = implied_lower_bounds_.at(j);
+      double old_upper_bound = implied_upper_bounds_.at(j);
+      if (!isInfinite(old_lower_bound) && implied_lower_bound <
+          old_lower_bound + core::kBoundImprovementTolerance *
+          std::max(1.0, std::fabs(old_lower_bound))) {
+        implied_lower_bound = -core::kInfinity;
+      }
+      if (!isInfinite(old_upper_bound) && implied_upper_bound >
+          old_upper_bound - core::kBoundImprovementTolerance *
+          std::max(1.0, std::fabs(old_upper_bound))) {
+        implied_upper_bound = core::kInfinity;
+      }
+      tightenImpliedBounds(j, implied_lower_bound, implied_upper_bound);
+      if (infeasible_) {return;}
+    }
+  }
+
+  bool Presolve::canSubstituteDoubletonEquation(
+    const int row_index, const int col_index, const int other_col_index
+  ) {
+    long long coefficient = problem_matrix_.at(row_index).at(col_index);
+    long long other_coefficient =
+      problem_matrix_.at(row_index).at(other_col_index);
+
+    // x_j = (c - b x_k) / a is only integer for every integer x_k
+    // if a divides both b and c.
+    if (solve_ip_) {
+      if (other_coefficient % coefficient != 0 ||
+          std::fmod(lower_bounds_.at(row_index), coefficient) != 0) {
+        return false;
+      }
+    }
+
+    // Substituting changes the coefficient of x_k in each row i
+    // from a_ik to a_ik - a_ij b / a, which must stay an integer.
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (i == row_index || !presolve_active_rows_.isActive(i)) {continue;}
+      long long product =
+        problem_matrix_.at(i).at(col_index) * other_coefficient;
+      if (product % coefficient != 0) {return false;}
+
+      long long new_coefficient =
+        problem_matrix_.at(i).at(other_col_index) - product / coefficient;
+      if (std::llabs(new_coefficient) >= core::kIntInfinity) {return false;}
+    }
+    return true;
+  }
+
+  void Presolve::updateStateDoubletonEquation(
+    const int row_index, const int col_index, const int other_col_index
+  ) {
+    int coefficient = problem_matrix_.at(row_index).at(col_index);
+    int other_coefficient = problem_matrix_.at(row_index).at(other_col_index);
+    double RHS = lower_bounds_.at(row_index);
+    double lower_bound = implied_lower_bounds_.at(col_index);
+    double upper_bound = implied_upper_bounds_.at(col_index);
+
+    // Move the implied bounds of x_j onto x_k using
+    // b x_k = c - a x_j.
+    double min_product = coefficient > 0 ?
+      lower_bound : upper_bound;
+    double max_product = coefficient > 0 ?
+      upper_bound : lower_bound;
+    double other_lower_bound = -core::kInfinity;
+    double other_upper_bound = core::kInfinity;
+    if (!isInfinite(max_product)) {
+      other_lower_bound = (RHS - coefficient * max_product)/other_coefficient;
+    }
+    if (!isInfinite(min_product)) {
+      other_upper_bound = (RHS - coefficient * min_product)/other_coefficient;
+    }
+    if (other_coefficient < 0) {
+      std::swap(other_lower_bound, other_upper_bound);
+      // Infinities swap sign with the bounds.
+      if (isInfinite(other_lower_bound)) {
+        other_lower_bound = -core::kInfinity;
+      }
+      if (isInfinite(other_upper_bound)) {
+        other_upper_bound = core::kInfinity;
+      }
+    }
+    if (solve_ip_) {
+      other_lower_bound = std::ceil(
+        other_lower_bound - core::kFeasibilityTolerance
+      );
+      other_upper_bound = std::floor(
+        other_upper_bound + core::kFeasibilityTolerance
+      );
+    }
+    tightenImpliedBounds(other_col_index, other_lower_bound, other_upper_bound);
+    if (infeasible_) {return;}
+
+    // Substitute x_j into every other row containing it, logging
+    // the original coefficient of x_k in each.
+    logRule(row_index, col_index, core::PresolveRulesIds::doubletonEquationId);
+    log_dependancies_.push_back(other_col_index);
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (i == row_index || !presolve_active_rows_.isActive(i)) {continue;}
+      int row_coefficient = problem_matrix_.at(i).at(col_index);
+      int old_coefficient = problem_matrix_.at(i).at(other_col_index);
+      int new_coefficient = old_coefficient - static_cast<long long>(
+        row_coefficient) * other_coefficient / coefficient;
+
+      // Swap the contributions of x_j and the old x_k for the
+      // new x_k in the row activities.
+      updateRowActivity(
+        i, row_coefficient, implied_lower_bounds_.at(col_index),
+        implied_upper_bounds_.at(col_index), -1
+      );
+      updateRowActivity(
+        i, old_coefficient, implied_lower_bounds_.at(other_col_index),
+        implied_upper_bounds_.at(other_col_index), -1
+      );
+      updateRowActivity(
+        i, new_coefficient, implied_lower_bounds_.at(other_col_index),
+        implied_upper_bounds_.at(other_col_index), 1
+      );
+      problem_matrix_.at(i).at(other_col_index) = new_coefficient;
+
+      double shift = row_coefficient * RHS / coefficient;
+      if (!isInfinite(lower_bounds_.at(i))) {lower_bounds_.at(i) -= shift;}
+      if (!isInfinite(upper_bounds_.at(i))) {upper_bounds_.at(i) -= shift;}
+      checkRowBoundsOverflow(i);
+
+      log_dependancies_.push_back(i);
+      log_dependancies_.push_back(old_coefficient);
+    }
+
+    presolve_active_rows_.deactivate(row_index);
+    presolve_active_columns_.deactivate(col_index);
+  }
+
+  void Presolve::applyDoubletonEquationPostsolve(
+    const int row_index, const int col_index, const int log_index
+  ) {
+    int other_col_index = getLogDependancy(log_index, 0);
+    int coefficient = problem_matrix_.at(row_index).at(col_index);
+    double RHS = lower_bounds_.at(row_index);
+
+    // Restore the coefficients and bounds of the rows x_j was
+    // substituted into.
+    for (int k = 1; k + 1 < getLogDependanciesCount(log_index); k += 2) {
+      int i = getLogDependancy(log_index, k);
+      setPostsolveCoefficient(i, other_col_index, getLogDependancy(log_index, k + 1));
+
+      double shift = problem_matrix_.at(i).at(col_index) * RHS / coefficient;
+      if (!isInfinite(lower_bounds_.at(i))) {lower_bounds_.at(i) += shift;}
+      if (!isInfinite(upper_bounds_.at(i))) {upper_bounds_.at(i) += shift;}
+    }
+
+    if (!postsolve_active_cols_.isActive(other_col_index)) {return;}
+
+    int other_coefficient = problem_matrix_.at(row_index).at(other_col_index);
+    setPostsolveValue(col_index, (RHS - other_coefficient *
+      feasible_solution_.at(other_col_index))/coefficient);
+
+    if (isRowActivePostsolve(row_index)) {
+      if (checkConstraint(row_index, static_cast<int>(core::PresolveRulesIds::doubletonEquationId))) {
+        postsolve_active_rows_.activate(row_index);
+      }
+    }
+  }
+
+  std::size_t Presolve::getColumnHash(const int col_index) {
+    int divisor = 0;
+    int first_coefficient = 0;
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (!presolve_active_rows_.isActive(i)) {continue;}
+      int coefficient = problem_matrix_.at(i).at(col_index);
+      if (first_coefficient == 0) {first_coefficient = coefficient;}
+      divisor = std::gcd(divisor, coefficient);
+    }
+    if (divisor == 0) {return 0;}
+    if (first_coefficient < 0) {divisor = -divisor;}
+
+    // Combine the row indices and normalised coefficients, columns
+    // which are multiples of each other give the same values.
+    std::size_t hash = 0;
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (!presolve_active_rows_.isActive(i)) {continue;}
+      int coefficient = problem_matrix_.at(i).at(col_index)/divisor;
+      hash ^= std::hash<int>()(i) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      hash ^= std::hash<int>()(coefficient) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+
+  double Presolve::getParallelColRatio(
+    const int col_index, const int other_col_index
+  ) {
+    std::vector<int> rows;
+    std::vector<int> other_rows;
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (presolve_active_rows_.isActive(i)) {rows.push_back(i);}
+    }
+    for (auto&i : cols_non_zeros_indices_.at(other_col_index)) {
+      if (presolve_active_rows_.isActive(i)) {other_rows.push_back(i);}
+    }
+    if (rows.empty() || rows != other_rows) {return 0;}
+
+    // a_k = s a_j holds exactly if a_ik a_j0 = a_ij a_k0 in
+    // every row.
+    long long first_coefficient = problem_matrix_.at(rows.at(0)).at(col_index);
+    long long other_first_coefficient =
+      problem_matrix_.at(rows.at(0)).at(other_col_index);
+    for (auto&i : rows) {
+      if (problem_matrix_.at(i).at(other_col_index) * first_coefficient !=
+          problem_matrix_.at(i).at(col_index) * other_first_coefficient) {
+        return 0;
+      }
+    }
+    return static_cast<double>(other_first_coefficient)/first_coefficient;
+  }
+
+  bool Presolve::canMergeParallelCols(
+    const int col_index, const int other_col_index, const double ratio
+  ) {
+    if (!solve_ip_) {return true;}
+    if (ratio != std::trunc(ratio)) {return false;}
+    if (std::fabs(ratio) == 1) {return true;}
+    if (isFixedCol(other_col_index)) {return true;}
+
+    // x_j + s x_k takes every integer value only if x_j can fill
+    // the gaps between consecutive multiples of s.
+    double lower_bound = implied_lower_bounds_.at(col_index);
+    double upper_bound = implied_upper_bounds_.at(col_index);
+    return isInfinite(lower_bound) || isInfinite(upper_bound) ||
+      upper_bound - lower_bound >= std::fabs(ratio) - 1;
+  }
+
+  void Presolve::updateStateParallelCol(
+    const int col_index, const int other_col_index, const double ratio
+  ) {
+    double lower_bound = implied_lower_bounds_.at(col_index);
+    double upper_bound = implied_upper_bounds_.at(col_index);
+    double other_lower_bound = implied_lower_bounds_.at(other_col_index);
+    double other_upper_bound = implied_upper_bounds_.at(other_col_index);
+
+    // Bounds of x_j + s x_k, infinite if either part is.
+    double other_min = ratio > 0 ? other_lower_bound : other_upper_bound;
+    double other_max = ratio > 0 ? other_upper_bound : other_lower_bound;
+    double merged_lower_bound = -core::kInfinity;
+    double merged_upper_bound = core::kInfinity;
+    if (!isInfinite(lower_bound) && !isInfinite(other_min)) {
+      merged_lower_bound = lower_bound + ratio * other_min;
+    }
+    if (!isInfinite(upper_bound) && !isInfinite(other_max)) {
+      merged_upper_bound = upper_bound + ratio * other_max;
+    }
+
+    // Take x_k out of the row activities, its contribution is
+    // now part of that of x_j.
+    for (auto&i : cols_non_zeros_indices_.at(other_col_index)) {
+      if (presolve_active_rows_.isActive(i)) {
+        updateRowActivity(
+          i, problem_matrix_.at(i).at(other_col_index),
+          other_lower_bound, other_upper_bound, -1
         );
+      }
+    }
+    updateImpliedBounds(col_index, merged_lower_bound, merged_upper_bound);
+
+    presolve_active_columns_.deactivate(other_col_index);
+
+    logRule(-1, col_index, core::PresolveRulesIds::parallelColId);
+    log_dependancies_.push_back(other_col_index);
+    log_values_.push_back(ratio);
+    log_values_.push_back(lower_bound);
+    log_values_.push_back(upper_bound);
+  }
+
+  void Presolve::applyParallelColPostsolve(
+    const int col_index, const int log_index
+  ) {
+    int other_col_index = getLogDependancy(log_index, 0);
+    double ratio = getLogValue(log_index, 0);
+    implied_lower_bounds_.at(col_index) = getLogValue(log_index, 1);
+    implied_upper_bounds_.at(col_index) = getLogValue(log_index, 2);
+    if (!postsolve_active_cols_.isActive(col_index)) {return;}
+
+    // Pick x_k so that x_j = y - s x_k stays within its bounds,
+    // that is y - u_j <= s x_k <= y - l_j.
+    double merged_value = feasible_solution_.at(col_index);
+    double lower_bound = implied_lower_bounds_.at(other_col_index);
+    double upper_bound = implied_upper_bounds_.at(other_col_index);
+    double min_product = -core::kInfinity;
+    double max_product = core::kInfinity;
+    if (!isInfinite(implied_upper_bounds_.at(col_index))) {
+      min_product = merged_value - implied_upper_bounds_.at(col_index);
+    }
+    if (!isInfinite(implied_lower_bounds_.at(col_index))) {
+      max_product = merged_value - implied_lower_bounds_.at(col_index);
+    }
+    double product_lower_bound = ratio > 0 ? min_product : max_product;
+    double product_upper_bound = ratio > 0 ? max_product : min_product;
+    if (!isInfinite(product_lower_bound)) {
+      lower_bound = std::max(lower_bound, product_lower_bound/ratio);
+    }
+    if (!isInfinite(product_upper_bound)) {
+      upper_bound = std::min(upper_bound, product_upper_bound/ratio);
+    }
+    if (solve_ip_) {
+      lower_bound = std::ceil(lower_bound - core::kFeasibilityTolerance);
+      upper_bound = std::floor(upper_bound + core::kFeasibilityTolerance);
+    }
+
+    double other_value = std::min(std::max(0.0, lower_bound), upper_bound);
+    setPostsolveValue(other_col_index, other_value);
+    setPostsolveValue(col_index, merged_value - ratio * other_value);
+  }
+
+  int Presolve::getDominatedColDirection(const int col_index) {
+    bool is_dominated_upwards = true;
+    bool is_dominated_downwards = true;
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (!presolve_active_rows_.isActive(i)) {continue;}
+      bool is_positive = problem_matrix_.at(i).at(col_index) > 0;
+      bool is_lower_bound_infinite = isInfinite(lower_bounds_.at(i));
+      bool is_upper_bound_infinite = isInfinite(upper_bounds_.at(i));
+      if (is_positive) {
+        is_dominated_upwards &= is_upper_bound_infinite;
+        is_dominated_downwards &= is_lower_bound_infinite;
       } else {
-        feasible_value = RHS/variable_coefficient;
-      }
-
-      if (feasible_value == core::kIntInfinity) {infeasible_ = true;}
-      else {
-        feasible_solution_.at(col_index) = feasible_value;
-        postsolve_active_cols_.at(col_index) = true;
-        // Check if we have found feasible values for all variables in the 
-        // row. If so, check if the row (constraint) is satisfied, and if 
-        // so turn on row in postsolve.
-        if (isRowActivePostsolve(row_index)) {
-          if (checkConstraint(row_index, 6)) {
-            postsolve_active_rows_.at(row_index) = true;
-          }
-        }
+        is_dominated_upwards &= is_lower_bound_infinite;
+        is_dominated_downwards &= is_upper_bound_infinite;
+      }
+    }
+    if (is_dominated_upwards) {return 1;}
+    if (is_dominated_downwards) {return -1;}
+    return 0;
+  }
+
+  void Presolve::updateStateDominatedCol(
+    const int col_index, const int direction
+  ) {
+    // Any feasible solution stays feasible with the column moved to
+    // its bound, so fix it there if the bound is finite.
+    double bound = direction > 0 ?
+      implied_upper_bounds_.at(col_index) : implied_lower_bounds_.at(col_index);
+    if (!isInfinite(bound)) {
+      updateImpliedBounds(col_index, bound, bound);
+      implied_bounds_changed_ = true;
+      updateStateFixedCol(col_index);
+      return;
+    }
+
+    // Otherwise the column can satisfy all of its rows on its own.
+    logRule(-1, col_index, core::PresolveRulesIds::dominatedColId);
+    log_dependancies_.push_back(direction);
+    for (auto&i : cols_non_zeros_indices_.at(col_index)) {
+      if (!presolve_active_rows_.isActive(i)) {continue;}
+      presolve_active_rows_.deactivate(i);
+      log_dependancies_.push_back(i);
+    }
+    presolve_active_columns_.deactivate(col_index);
+  }
+
+  void Presolve::applyDominatedColPostsolve(
+    const int col_index, const int log_index
+  ) {
+    int direction = getLogDependancy(log_index, 0);
+    double value = clampToImpliedBounds(col_index, 0);
+
+    // Move the column in the dominated direction until every
+    // removed row reaches its finite bound.
+    for (int k = 1; k < getLogDependanciesCount(log_index); ++k) {
+      int i = getLogDependancy(log_index, k);
+      int coefficient = problem_matrix_.at(i).at(col_index);
+      double activity = postsolve_row_activities_.at(i);
+      if (postsolve_active_cols_.isActive(col_index)) {
+        activity -= coefficient*feasible_solution_.at(col_index);
+      }
+
+      bool is_increasing = (coefficient > 0) == (direction > 0);
+      double bound = is_increasing ? lower_bounds_.at(i) : upper_bounds_.at(i);
+      if (isInfinite(bound)) {continue;}
+      double limit = (bound - activity)/coefficient;
+      if (solve_ip_) {
+        limit = direction > 0 ? std::ceil(limit - core::kFeasibilityTolerance) :
+          std::floor(limit + core::kFeasibilityTolerance);
+      }
+      value = direction > 0 ? std::max(value, limit) : std::min(value, limit);
+    }
+    setPostsolveValue(col_index, value);
+
+    for (int k = 1; k < getLogDependanciesCount(log_index); ++k) {
+      applyRemovedRowPostsolve(
+        getLogDependancy(log_index, k),
+        static_cast<int>(core::PresolveRulesIds::dominatedColId)
+      );
+    }
+  }
+
+  void Presolve::applyRemovedRowPostsolve(
+    const int row_index, const int rule_id
+  ) {
+    if (isRowActivePostsolve(row_index)) {
+      if (checkConstraint(row_index, rule_id)) {
+        postsolve_active_rows_.activate(row_index);
       }
     }
   }
 
   void Presolve::applyPresolveRowRules() {
-    for (std::size_t i = 0; i < constraints_count_; ++i) {
-      // If row is active, apply row rules.
-      if (presolve_active_rows_.at(i)) {
-        // Check if it is a free row, and if so update state
-        // accordingly and continue to the next iteration.
-        if (checkIsRowFree(i)) {
-          updateStateFreeRow(i);
-          continue;
+    // Apply the row rules to each active row.
+    for (int i = presolve_active_rows_.next(0); i < constraints_count_;
+         i = presolve_active_rows_.next(i + 1)) {
+      // Check if it is a free row, and if so update state
+      // accordingly and continue to the next iteration.
+      if (checkIsRowFree(i)) {
+        startRule();
+        updateStateFreeRow(i);
+        endRule(core::PresolveRulesIds::freeRowId);
+        continue;
+      }
+      // Check if all variables of the row have been removed.
+      if (rows_non_zero_variables_.at(i).empty()) {
+        startRule();
+        updateStateEmptyRow(i);
+        endRule(core::PresolveRulesIds::emptyRowId);
+        if (infeasible_) {break;}
+        continue;
+      }
+      // Check if row is parallel to another row from row 0
+      // to row i-1, or from the start of the equalities to i-1.
+      int parallel_row_search_start = 0;
+      if (i >= inequalities_count_) {
+        parallel_row_search_start = inequalities_count_;
+      }
+      int parallel_row = getParallelRow(i, parallel_row_search_start);
+
+      // If parallel row is found, check feasibility and 
+      // if feasible call updateSateParallelRows.
+      if (parallel_row != -1) {
+        std::vector<int> sorted_rows = sortParallelRowsBySize(i, parallel_row);
+        int small_row_index = sorted_rows.at(0);
+        int large_row_index = sorted_rows.at(1);
+        double large_to_small_ratio = static_cast<double>(problem_matrix_.at(large_row_index).at(rows_non_zero_variables_.at(large_row_index).at(0)))/problem_matrix_.at(small_row_index).at(rows_non_zero_variables_.at(small_row_index).at(0));
+
+        // If parallel row not feasible, set problem to infeasible
+        // and break, else update state.
+        if (!checkAreParallelRowsFeasible(
+          small_row_index, large_row_index, large_to_small_ratio)
+        ) {
+          infeasible_ = true;
+          infeasible_by_PR_ = true;
+          break;
+        } else {
+          startRule();
+          updateStateParallelRow(
+            small_row_index, large_row_index, large_to_small_ratio
+          );
+          endRule(core::PresolveRulesIds::parallelRowId);
         }
-        // Check if row is parallel to another row from row 0
-        // to row i-1, or from the start of the equalities to i-1.
-        int parallel_row_search_start = 0;
-        if (i >= inequalities_count_) {
-          parallel_row_search_start = inequalities_count_;
-        }
-        int parallel_row = getParallelRow(i, parallel_row_search_start);
-
-        // If parallel row is found, check feasibility and 
-        // if feasible call updateSateParallelRows.
-        if (parallel_row != -1) {
-          std::vector<int> sorted_rows = sortParallelRowsBySize(i, parallel_row);
-          int small_row_index = sorted_rows.at(0);
-          int large_row_index = sorted_rows.at(1);
-          double large_to_small_ratio = static_cast<double>(problem_matrix_.at(large_row_index).at(rows_non_zero_variables_.at(large_row_index).at(0)))/problem_matrix_.at(small_row_index).at(rows_non_zero_variables_.at(small_row_index).at(0));
-          double large_lower_bound_by_ratio = lower_bounds_.at(large_row_index)/large_to_small_ratio;
-
-          // If parallel row not feasible, set problem to infeasible
-          // and break, else update state.
-          if (!checkAreParallelRowsFeasible(
-            small_row_index, large_to_small_ratio, 
-            large_lower_bound_by_ratio)
-          ) {
-            infeasible_ = true;
-            infeasible_by_PR_ = true;
-            break;
-          } else {
-            updateStateParallelRow(
-              small_row_index, large_row_index, 
-              large_to_small_ratio, large_lower_bound_by_ratio
-            );
-          }
-          // if row i was the large row in parallel rows it will have 
-          // been turned off so we don't check the rest of the rules.
-          if (large_row_index == i) {continue;}
-        }
-        int row_non_zeros_count = rows_non_zero_variables_.at(i).size();
-
-        // If row is a row singleton, check if it is a singleton 
-        // variable, row singleton equality or row singleton inequality,
-        // and update state accordingly.
-        if (row_non_zeros_count == 1) {
-          int non_zero_variable = rows_non_zero_variables_.at(i).at(0);
-          int corresponding_col_non_zeros_count = cols_non_zeros_indices_.at(
-            non_zero_variable
-          ).size();
-
-          // If it is a singleton variable, update state accordingly.
-          if (corresponding_col_non_zeros_count == 1) {
-            updateStateRowAndColSingleton(i, non_zero_variable);
-          }
-          
-          // If it is not a singleton variable, check if is an equality
-          // or an inequality and update state accordingly.
-          else if (i < inequalities_count_) { // Inequality
-            if (std::find(inequality_singletons_.begin(), inequality_singletons_.end(), i) == inequality_singletons_.end()) {
-              updateStateRowSingletonInequality(i, non_zero_variable);
-              inequality_singletons_.push_back(i);
-            }
-          }
-          else {
-            updateStateRowSingletonEquality(i, non_zero_variable);
+        // if row i was the large row in parallel rows it will have 
+        // been turned off so we don't check the rest of the rules.
+        if (large_row_index == i) {continue;}
+      }
+      int row_non_zeros_count = rows_non_zero_variables_.at(i).size();
+
+      // If row is a row singleton, check if it is a singleton 
+      // variable, row singleton equality or row singleton inequality,
+      // and update state accordingly.
+      if (row_non_zeros_count == 1) {
+        int non_zero_variable = rows_non_zero_variables_.at(i).at(0);
+        int corresponding_col_non_zeros_count = cols_non_zeros_indices_.at(
+          non_zero_variable
+        ).size();
+
+        // If it is a singleton variable, update state accordingly.
+        if (corresponding_col_non_zeros_count == 1) {
+          startRule();
+          updateStateRowAndColSingleton(i, non_zero_variable);
+          endRule(core::PresolveRulesIds::rowAndColSingletonId);
+        }
+        
+        // If it is not a singleton variable, check if is an equality
+        // or an inequality and update state accordingly.
+        else if (i < inequalities_count_) { // Inequality
+          if (std::find(inequality_singletons_.begin(), inequality_singletons_.end(), i) == inequality_singletons_.end()) {
+            startRule();
+            updateStateRowSingletonInequality(i, non_zero_variable);
+            endRule(core::PresolveRulesIds::rowSingletonId);
+            inequality_singletons_.push_back(i);
           }
         }
+        else {
+          startRule();
+          updateStateRowSingletonEquality(i, non_zero_variable);
+          endRule(core::PresolveRulesIds::rowSingletonId);
+        }
       }
     }
   }
 
   void Presolve::applyPresolveColRules() {
-    for (std::size_t j = 0; j < variables_count_; ++j) {
-      // If column is active, apply col rules.
-      if (presolve_active_columns_.at(j)) {
-        int non_zeros_count = cols_non_zeros_indices_.at(j).size();
+    // Apply the col rules to each active column.
+    for (int j = presolve_active_columns_.next(0); j < variables_count_;
+         j = presolve_active_columns_.next(j + 1)) {
+      // Rows may have been removed since the nonzeros were
+      // computed, only count the active ones.
+      std::vector<int> active_rows;
+      for (auto&i : cols_non_zeros_indices_.at(j)) {
+        if (presolve_active_rows_.isActive(i)) {active_rows.push_back(i);}
+      }
+      int non_zeros_count = active_rows.size();
+
+      // If column is a fixed column update state 
+      // accordingly.
+      if (isFixedCol(j)) {
+        startRule();
+        updateStateFixedCol(j);
+        endRule(core::PresolveRulesIds::fixedColId);
+        continue;
+      }
+      // If column is an empty column, update state accordingly.
+      else if (non_zeros_count == 0) {
+        startRule();
+        updateStateEmptyCol(j);
+        endRule(core::PresolveRulesIds::emptyColId);
+        continue;
+      }
+      // If column is free col, update state accordingly.
+      else if (non_zeros_count == 1) {
+        int non_zero_row = active_rows.at(0);
+
+        if (isFreeColSubstitution(non_zero_row, j)) {
+          startRule();
+          updateStateFreeColSubstitution(non_zero_row, j);
+          endRule(core::PresolveRulesIds::freeColSubsId);
+          continue;
+        } 
+      }
+      // If column is dominated, fix it or remove it with its rows.
+      int direction = getDominatedColDirection(j);
+      if (direction != 0) {
+        startRule();
+        updateStateDominatedCol(j, direction);
+        endRule(core::PresolveRulesIds::dominatedColId);
+      }
+    }
+  }
 
-        // If column is a fixed column update state 
-        // accordingly.
-        if (isFixedCol(j)) {
-          updateStateFixedCol(j);
+  void Presolve::applyPresolveParallelColRules() {
+    // Bucket the columns by hash so that only columns which are
+    // likely to be parallel are compared.
+    std::unordered_map<std::size_t, std::vector<int>> buckets;
+    for (int j = presolve_active_columns_.next(0); j < variables_count_;
+         j = presolve_active_columns_.next(j + 1)) {
+      std::size_t hash = getColumnHash(j);
+      if (hash != 0) {buckets[hash].push_back(j);}
+    }
+
+    for (auto&bucket : buckets) {
+      std::vector<int>&cols = bucket.second;
+      if (cols.size() < 2) {continue;}
+
+      // Keep the column with the smallest coefficients so that
+      // ratios to the others are integers where possible.
+      std::vector<int> first_coefficients;
+      for (auto&j : cols) {
+        int first_coefficient = 0;
+        for (auto&i : cols_non_zeros_indices_.at(j)) {
+          if (presolve_active_rows_.isActive(i)) {
+            first_coefficient = std::abs(problem_matrix_.at(i).at(j));
+            break;
+          }
         }
-        // If column is an empty column, update state accordingly.
-        else if (non_zeros_count == 0) {
-          updateStateEmptyCol(j);
+        first_coefficients.push_back(first_coefficient);
+      }
+      std::vector<int> order(cols.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return first_coefficients.at(a) < first_coefficients.at(b);
+      });
+
+      for (std::size_t a = 0; a < order.size(); ++a) {
+        int col_index = cols.at(order.at(a));
+        if (!presolve_active_columns_.isActive(col_index)) {continue;}
+        for (std::size_t b = a + 1; b < order.size(); ++b) {
+          int other_col_index = cols.at(order.at(b));
+          if (!presolve_active_columns_.isActive(other_col_index)) {continue;}
+          double ratio = getParallelColRatio(col_index, other_col_index);
+          if (ratio != 0 && canMergeParallelCols(col_index, other_col_index, ratio)) {
+            startRule();
+            updateStateParallelCol(col_index, other_col_index, ratio);
+            endRule(core::PresolveRulesIds::parallelColId);
+          }
         }
-        // If column is free col, update state accordingly.
-        else if (non_zeros_count == 1) {
-          int non_zero_row = cols_non_zeros_indices_.at(j).at(0);
+      }
+    }
+  }
+
+  void Presolve::applyPresolveActivityRules() {
+    for (int i = presolve_active_rows_.next(0); i < constraints_count_;
+         i = presolve_active_rows_.next(i + 1)) {
+      if (rows_non_zero_variables_.at(i).empty()) {continue;}
+
+      double lower_bound = lower_bounds_.at(i);
+      double upper_bound = upper_bounds_.at(i);
+      bool is_max_activity_finite = max_activities_inf_count_.at(i) == 0;
+      bool is_min_activity_finite = min_activities_inf_count_.at(i) == 0;
+      double lower_tolerance =
+        core::kFeasibilityTolerance * (1 + std::fabs(lower_bound));
+      double upper_tolerance =
+        core::kFeasibilityTolerance * (1 + std::fabs(upper_bound));
+
+      // The row cannot be satisfied if its activity cannot reach
+      // either of its bounds.
+      if ((is_max_activity_finite && !isInfinite(lower_bound) &&
+           max_activities_.at(i) < lower_bound - lower_tolerance) ||
+          (is_min_activity_finite && !isInfinite(upper_bound) &&
+           min_activities_.at(i) > upper_bound + upper_tolerance)) {
+        infeasible_ = true;
+        break;
+      }
+
+      if (isRowRedundant(i)) {
+        startRule();
+        updateStateRedundantRow(i);
+        endRule(core::PresolveRulesIds::redundantRowId);
+        continue;
+      }
+
+      // If the activity can only just reach a bound, every variable
+      // is forced to the bound that gets it there. No tolerance here,
+      // fixing at approximate values would make postsolve fail.
+      if (is_max_activity_finite && !isInfinite(lower_bound) &&
+          max_activities_.at(i) <= lower_bound) {
+        startRule();
+        updateStateForcingRow(i, true);
+        endRule(core::PresolveRulesIds::forcingRowId);
+      } else if (is_min_activity_finite && !isInfinite(upper_bound) &&
+                 min_activities_.at(i) >= upper_bound) {
+        startRule();
+        updateStateForcingRow(i, false);
+        endRule(core::PresolveRulesIds::forcingRowId);
+      } else {
+        propagateRowBounds(i);
+      }
+      if (infeasible_) {break;}
+    }
+  }
+
+  void Presolve::applyPresolveDoubletonRules() {
+    // Rows and columns changed by a substitution in this pass
+    // have out of date nonzeros until the next iteration.
+    std::vector<bool> changed_rows(constraints_count_, false);
+    std::vector<bool> changed_cols(variables_count_, false);
+
+    for (int i = presolve_active_rows_.next(inequalities_count_); i < constraints_count_;
+         i = presolve_active_rows_.next(i + 1)) {
+      if (changed_rows.at(i)) {continue;}
+      if (lower_bounds_.at(i) != upper_bounds_.at(i)) {continue;}
+
+      // Find the row's active variables, columns may have been
+      // removed since the nonzeros were computed.
+      std::vector<int> row_cols;
+      for (auto&j : rows_non_zero_variables_.at(i)) {
+        if (presolve_active_columns_.isActive(j)) {row_cols.push_back(j);}
+      }
+      if (row_cols.size() != 2) {continue;}
+      if (changed_cols.at(row_cols.at(0)) || changed_cols.at(row_cols.at(1))) {
+        continue;
+      }
 
-          if (isFreeColSubstitution(non_zero_row, j)) {
-            updateStateFreeColSubstitution(non_zero_row, j);
-          } 
+      // Prefer substituting a variable with a unit coefficient.
+      int col_index = row_cols.at(0);
+      int other_col_index = row_cols.at(1);
+      if (std::abs(problem_matrix_.at(i).at(other_col_index)) <
+          std::abs(problem_matrix_.at(i).at(col_index))) {
+        std::swap(col_index, other_col_index);
+      }
+      if (!canSubstituteDoubletonEquation(i, col_index, other_col_index)) {
+        std::swap(col_index, other_col_index);
+        if (!canSubstituteDoubletonEquation(i, col_index, other_col_index)) {
+          continue;
         }
       }
+
+      for (auto&k : cols_non_zeros_indices_.at(col_index)) {
+        changed_rows.at(k) = true;
+      }
+      changed_cols.at(col_index) = true;
+      changed_cols.at(other_col_index) = true;
+
+      startRule();
+      updateStateDoubletonEquation(i, col_index, other_col_index);
+      endRule(core::PresolveRulesIds::doubletonEquationId);
+      if (infeasible_) {break;}
     }
   }
 
@@ -760,15 +1666,74 @@ namespace logical_solver{
     return true;
   }
 
-  bool Presolve::isRowActivePostsolve(const int row_index) {
-    for (std::size_t j = 0; j < variables_count_; ++j) {
-      if (problem_matrix_.at(row_index).at(j) != 0) {
-        if (!postsolve_active_cols_.at(j)) {
-          return false;
+  double Presolve::clampToImpliedBounds(
+    const int col_index, const double value
+  ) {
+    return std::min(
+      std::max(value, implied_lower_bounds_.at(col_index)),
+      implied_upper_bounds_.at(col_index)
+    );
+  }
+
+  void Presolve::initPostsolveActivities() {
+    postsolve_row_activities_.assign(constraints_count_, 0);
+    postsolve_row_magnitudes_.assign(constraints_count_, 0);
+    postsolve_unresolved_counts_.assign(constraints_count_, 0);
+    postsolve_cols_rows_.assign(variables_count_, {});
+
+    for (int i = 0; i < constraints_count_; ++i) {
+      for (int j = 0; j < variables_count_; ++j) {
+        int coefficient = problem_matrix_.at(i).at(j);
+        if (coefficient == 0) {continue;}
+        postsolve_cols_rows_.at(j).push_back(i);
+        if (postsolve_active_cols_.isActive(j)) {
+          double term = coefficient*feasible_solution_.at(j);
+          postsolve_row_activities_.at(i) += term;
+          postsolve_row_magnitudes_.at(i) += std::fabs(term);
+        } else {
+          postsolve_unresolved_counts_.at(i) += 1;
         }
       }
     }
-    return true;
+  }
+
+  void Presolve::setPostsolveValue(const int col_index, const double value) {
+    bool is_active = postsolve_active_cols_.isActive(col_index);
+    double old_value = is_active ? feasible_solution_.at(col_index) : 0;
+
+    for (auto&i : postsolve_cols_rows_.at(col_index)) {
+      int coefficient = problem_matrix_.at(i).at(col_index);
+      if (coefficient == 0) {continue;}
+      postsolve_row_activities_.at(i) += coefficient*(value - old_value);
+      postsolve_row_magnitudes_.at(i) += std::fabs(coefficient*value) - std::fabs(coefficient*old_value);
+      if (!is_active) {postsolve_unresolved_counts_.at(i) -= 1;}
+    }
+    feasible_solution_.at(col_index) = value;
+    postsolve_active_cols_.activate(col_index);
+  }
+
+  void Presolve::setPostsolveCoefficient(
+    const int row_index, const int col_index, const int coefficient
+  ) {
+    int old_coefficient = problem_matrix_.at(row_index).at(col_index);
+    if (coefficient == old_coefficient) {return;}
+    std::vector<int> &col_rows = postsolve_cols_rows_.at(col_index);
+    if (std::find(col_rows.begin(), col_rows.end(), row_index) == col_rows.end()) {
+      col_rows.push_back(row_index);
+    }
+
+    if (postsolve_active_cols_.isActive(col_index)) {
+      double value = feasible_solution_.at(col_index);
+      postsolve_row_activities_.at(row_index) += (coefficient - old_coefficient)*value;
+      postsolve_row_magnitudes_.at(row_index) += std::fabs(coefficient*value) - std::fabs(old_coefficient*value);
+    } else {
+      postsolve_unresolved_counts_.at(row_index) += (coefficient != 0) - (old_coefficient != 0);
+    }
+    problem_matrix_.at(row_index).at(col_index) = coefficient;
+  }
+
+  bool Presolve::isRowActivePostsolve(const int row_index) {
+    return postsolve_unresolved_counts_.at(row_index) == 0;
   }
 
   void Presolve::setPrintUnsatisfiedConstraints() {
@@ -778,19 +1743,14 @@ namespace logical_solver{
   bool Presolve::checkConstraint(
     const int row_index, const int rule_id
   ) {
-    double constraint_value = 0;
-
-    // Loop through row active columns working out the 
-    // constraint value.
-    for (std::size_t j = 0; j < variables_count_; ++j) {
-      if (postsolve_active_cols_.at(j)) {
-        constraint_value += problem_matrix_.at(row_index).at(j)*feasible_solution_.at(j);
-      }
-    }
+    double constraint_value = postsolve_row_activities_.at(row_index);
+    double magnitude = postsolve_row_magnitudes_.at(row_index);
 
     // Check if constraint is satisfied, and if not 
-    // add index to unsatisfied constraints vector.
-    if (constraint_value < lower_bounds_.at(row_index) || constraint_value > upper_bounds_.at(row_index)) {
+    // add index to unsatisfied constraints vector. Values worked
+    // out by division are only exact up to round off.
+    double tolerance = core::kFeasibilityTolerance * (1 + magnitude);
+    if (constraint_value < lower_bounds_.at(row_index) - tolerance || constraint_value > upper_bounds_.at(row_index) + tolerance) {
       if (print_unsatisfied_constraints_) {
         std::cout<<""<<std::endl;
         printf(
@@ -812,37 +1772,69 @@ namespace logical_solver{
   }
 
   void Presolve::applyPresolve() {
-    int iteration_active_rows = presolve_active_rows_count_;
-    int iteration_active_cols = presolve_active_cols_count_;
-    while (presolve_active_rows_count_ > 0) {
+    int iteration_active_rows = presolve_active_rows_.count();
+    int iteration_active_cols = presolve_active_columns_.count();
+    computeRowActivities();
+    for (std::size_t k = 0; k < core::kMaxIterations; ++k) {
+      if (presolve_active_rows_.count() == 0) {break;}
+      implied_bounds_changed_ = false;
+      stats_.num_iterations += 1;
+
+      // Time each phase, which includes detecting the rules as well
+      // as applying them.
+      std::chrono::steady_clock::time_point phase_start_time =
+        std::chrono::steady_clock::now();
       getRowsAndColsNonZeros();
       applyPresolveRowRules();
+      stats_.row_rules_time_nanos += getElapsedNanos(phase_start_time);
+
+      phase_start_time = std::chrono::steady_clock::now();
+      if (!infeasible_) {applyPresolveActivityRules();}
+      stats_.activity_rules_time_nanos += getElapsedNanos(phase_start_time);
+
+      phase_start_time = std::chrono::steady_clock::now();
       applyPresolveColRules();
-      if (infeasible_) {break;}
+      stats_.col_rules_time_nanos += getElapsedNanos(phase_start_time);
+
+      phase_start_time = std::chrono::steady_clock::now();
+      if (!infeasible_) {applyPresolveParallelColRules();}
+      stats_.parallel_col_rules_time_nanos += getElapsedNanos(phase_start_time);
+
+      phase_start_time = std::chrono::steady_clock::now();
+      if (!infeasible_) {applyPresolveDoubletonRules();}
+      stats_.doubleton_rules_time_nanos += getElapsedNanos(phase_start_time);
+      if (infeasible_ || overflow_) {break;}
       
-      if (presolve_active_rows_count_ == iteration_active_rows && presolve_active_cols_count_ == iteration_active_cols) {
+      // Keep going while rows or columns are removed or bounds
+      // are tightened.
+      if (presolve_active_rows_.count() == iteration_active_rows && presolve_active_columns_.count() == iteration_active_cols && !implied_bounds_changed_) {
         break;
       } else {
-        iteration_active_rows = presolve_active_rows_count_;
-        iteration_active_cols = presolve_active_cols_count_;
+        iteration_active_rows = presolve_active_rows_.count();
+        iteration_active_cols = presolve_active_columns_.count();
       }
     }
 
-    if (presolve_active_rows_count_ == 0 && presolve_active_cols_count_ == 0) {
+    // Once a bound has left the exact range none of the reductions
+    // can be trusted, so presolve gives no verdict.
+    if (overflow_) {
+      infeasible_ = false;
+    } else if (presolve_active_rows_.count() == 0 && presolve_active_columns_.count() == 0) {
       reduced_to_empty_ = true;
     }
+    initPostsolveActivities();
   }
 
   void Presolve::applyPostsolve() {
-    postsolve_active_rows_.resize(constraints_count_, false);
-    postsolve_active_cols_.resize(variables_count_, false);
-    if (!infeasible_) {
-      while (!presolve_stack_.empty()) {
-        presolve_log rule_log = presolve_stack_.top();
-        int rule_id = rule_log.rule_id;
-        int row_index = rule_log.constraint_index;
-        int col_index = rule_log.variable_index;
-        
+    std::chrono::steady_clock::time_point postsolve_start_time =
+      std::chrono::steady_clock::now();
+    int log_index = static_cast<int>(log_rule_ids_.size()) - 1;
+    if (!infeasible_ && !overflow_) {
+      for (; log_index >= 0; --log_index) {
+        int rule_id = log_rule_ids_.at(log_index);
+        int row_index = log_row_indices_.at(log_index);
+        int col_index = log_col_indices_.at(log_index);
+
         if (rule_id == static_cast<int>(core::PresolveRulesIds::freeRowId)) {
           applyFreeRowPostsolve(row_index);
         }
@@ -859,19 +1851,128 @@ namespace logical_solver{
           applyEmptyColPostsolve(col_index);
         }
         else if (rule_id == static_cast<int>(core::PresolveRulesIds::fixedColId)) {
-          applyFixedColPostsolve(col_index, rule_log.dependancies);
+          applyFixedColPostsolve(col_index, log_index);
         } 
         else if (rule_id == static_cast<int>(core::PresolveRulesIds::freeColSubsId)) {
           applyFreeColSubstitutionPostsolve(row_index, col_index);
         }
+        else if (rule_id == static_cast<int>(core::PresolveRulesIds::doubletonEquationId)) {
+          applyDoubletonEquationPostsolve(row_index, col_index, log_index);
+        }
+        else if (rule_id == static_cast<int>(core::PresolveRulesIds::parallelColId)) {
+          applyParallelColPostsolve(col_index, log_index);
+        }
+        else if (rule_id == static_cast<int>(core::PresolveRulesIds::dominatedColId)) {
+          applyDominatedColPostsolve(col_index, log_index);
+        }
+        else if (rule_id == static_cast<int>(core::PresolveRulesIds::emptyRowId) ||
+                 rule_id == static_cast<int>(core::PresolveRulesIds::redundantRowId) ||
+                 rule_id == static_cast<int>(core::PresolveRulesIds::forcingRowId)) {
+          applyRemovedRowPostsolve(row_index, rule_id);
+        }
 
-        if (infeasible_) {
+        if (infeasible_ || overflow_) {
           break;
         }
-        // Remove rule from stack.
-        presolve_stack_.pop();
       }
     }
+    // Drop the entries which have been undone.
+    truncateLog(log_index + 1);
+
+    // Rows are only checked in postsolve once all their variables
+    // have values, so verify the whole solution at the end.
+    if (!infeasible_ && !overflow_ && (reduced_to_empty_ || reduced_solution_set_)) {
+      checkFeasibleSolution();
+    }
+    stats_.postsolve_time_nanos += getElapsedNanos(postsolve_start_time);
+  }
+
+  const core::PresolveStats &Presolve::getStats() const {
+    return stats_;
+  }
+
+  core::ReducedProblem Presolve::getReducedProblem() const {
+    core::ReducedProblem reduced_problem;
+    core::FormattedBoundedProblem &problem = reduced_problem.problem;
+
+    for (int j = presolve_active_columns_.next(0); j < variables_count_;
+         j = presolve_active_columns_.next(j + 1)) {
+      reduced_problem.column_indices.push_back(j);
+      problem.column_lower_bounds.push_back(isInfinite(implied_lower_bounds_.at(j)) ?
+        -core::kFloatInfinity : implied_lower_bounds_.at(j));
+      problem.column_upper_bounds.push_back(isInfinite(implied_upper_bounds_.at(j)) ?
+        core::kFloatInfinity : implied_upper_bounds_.at(j));
+    }
+
+    // The bounds of the active rows already have the contribution
+    // of the removed columns moved into them.
+    for (int i = presolve_active_rows_.next(0); i < constraints_count_;
+         i = presolve_active_rows_.next(i + 1)) {
+      reduced_problem.row_indices.push_back(i);
+      problem.row_lower_bounds.push_back(isInfinite(lower_bounds_.at(i)) ?
+        -core::kFloatInfinity : lower_bounds_.at(i));
+      problem.row_upper_bounds.push_back(isInfinite(upper_bounds_.at(i)) ?
+        core::kFloatInfinity : upper_bounds_.at(i));
+
+      std::vector<double> row;
+      row.reserve(reduced_problem.column_indices.size());
+      for (auto&j : reduced_problem.column_indices) {
+        row.push_back(problem_matrix_.at(i).at(j));
+      }
+      problem.problem_matrix.push_back(std::move(row));
+    }
+    return reduced_problem;
+  }
+
+  void Presolve::setReducedSolution(const std::vector<double> &solution) {
+    // The rows and columns left by presolve are the starting point
+    // of postsolve, the removed ones are added back as their rules
+    // are undone.
+    int k = 0;
+    for (int j = presolve_active_columns_.next(0); j < variables_count_;
+         j = presolve_active_columns_.next(j + 1)) {
+      setPostsolveValue(j, solution.at(k));
+      ++k;
+    }
+    for (int i = presolve_active_rows_.next(0); i < constraints_count_;
+         i = presolve_active_rows_.next(i + 1)) {
+      postsolve_active_rows_.activate(i);
+    }
+    reduced_solution_set_ = true;
+  }
+
+  void Presolve::checkFeasibleSolution() {
+    if (postsolve_active_cols_.count() != variables_count_) {
+      unsatisfied_constraints_ = true;
+      return;
+    }
+
+    for (std::size_t i = 0; i < constraints_count_; ++i) {
+      double constraint_value = 0;
+      double magnitude = 0;
+      for (std::size_t j = 0; j < variables_count_; ++j) {
+        double term = problem_matrix_.at(i).at(j)*feasible_solution_.at(j);
+        constraint_value += term;
+        magnitude += std::fabs(term);
+      }
+
+      double tolerance = core::kFeasibilityTolerance * (1 + magnitude);
+      if (constraint_value < original_lower_bounds_.at(i) - tolerance ||
+          constraint_value > original_upper_bounds_.at(i) + tolerance) {
+        if (print_unsatisfied_constraints_) {
+          printf(
+            "Constraint %d is unsatisfied by the postsolve solution.\n",
+            static_cast<int>(i)
+          );
+        }
+        unsatisfied_constraints_ = true;
+        return;
+      }
+    }
+  }
+
+  const std::vector<double> &Presolve::getFeasibleSolution() const {
+    return feasible_solution_;
   }
 
   void Presolve::printFeasibleSolution() {
@@ -885,22 +1986,22 @@ namespace logical_solver{
     std::cout<<"Constraints Bounds"<<std::endl;;
 
     for (std::size_t i = 0; i < constraints_count_; ++i) {
-      int lower_bound = lower_bounds_.at(i);
-      int upper_bound = upper_bounds_.at(i);
+      double lower_bound = lower_bounds_.at(i);
+      double upper_bound = upper_bounds_.at(i);
 
       std::string lower_str;
       std::string upper_str;
 
-      if (lower_bound == -core::kIntInfinity) {
+      if (isInfinite(lower_bound)) {
         lower_str = "-Inf";
       } else {
-        lower_str = std::to_string(lower_bound);
+        lower_str = std::to_string(static_cast<long long>(lower_bound));
       }
 
-      if (upper_bound == core::kIntInfinity) {
+      if (isInfinite(upper_bound)) {
         upper_str = "Inf";
       } else {
-        upper_str = std::to_string(upper_bound);
+        upper_str = std::to_string(static_cast<long long>(upper_bound));
       }
       
       std::cout << lower_str << ", " << upper_str << std::endl;
@@ -913,22 +2014,22 @@ namespace logical_solver{
     std::cout<<"Implied Bounds"<<std::endl;;
 
     for (std::size_t i = 0; i < variables_count_; ++i) {
-      int lower_bound = implied_lower_bounds_.at(i);
-      int upper_bound = implied_upper_bounds_.at(i);
+      double lower_bound = implied_lower_bounds_.at(i);
+      double upper_bound = implied_upper_bounds_.at(i);
 
       std::string lower_str;
       std::string upper_str;
 
-      if (lower_bound == -core::kIntInfinity) {
+      if (isInfinite(lower_bound)) {
         lower_str = "-Inf";
       } else {
-        lower_str = std::to_string(lower_bound);
+        lower_str = std::to_string(static_cast<long long>(lower_bound));
       }
 
-      if (upper_bound == core::kIntInfinity) {
+      if (isInfinite(upper_bound)) {
         upper_str = "Inf";
       } else {
-        upper_str = std::to_string(upper_bound);
+        upper_str = std::to_string(static_cast<long long>(upper_bound));
       }
       
       std::cout << lower_str << ", " << upper_str << std::endl;
@@ -1,10 +1,15 @@
+#pragma once
+
 #include "../../core/consts.hpp"
 #include "../../core/types.hpp"
+#include "active_set.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <iomanip>
 #include <limits>
-#include <stack>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -17,6 +22,10 @@ public:
   bool reduced_to_empty_;
   bool infeasible_;
   bool infeasible_by_PR_;
+  // Set if a bound left the range in which doubles hold integers
+  // exactly, presolve then gives no verdict and the original
+  // problem has to be solved instead.
+  bool overflow_;
   bool unsatisfied_constraints_;
   bool print_unsatisfied_constraints_;
 
@@ -45,6 +54,45 @@ public:
    */
   void applyPostsolve();
 
+  /**
+   * @brief Gets the rows and columns presolve could not remove as a
+   * bounded problem, along with the original index of each, so that
+   * it can be handed to another solver. Only meaningful after
+   * applyPresolve and before applyPostsolve, as postsolve restores
+   * the coefficients doubleton equations substituted out.
+   *
+   * @return core::ReducedProblem.
+   */
+  core::ReducedProblem getReducedProblem() const;
+
+  /**
+   * @brief Sets the values of the columns of the reduced problem,
+   * found by another solver, so that applyPostsolve extends them to
+   * a solution of the original problem and checks it.
+   *
+   * @param std::vector<double> solution: value of each column of
+   * the reduced problem, in the order given by getReducedProblem.
+   * @return void.
+   */
+  void setReducedSolution(const std::vector<double> &solution);
+
+  /**
+   * @brief Gets the counters gathered by presolve and postsolve:
+   * applications, rows and columns removed and time spent per rule,
+   * and time spent per presolve phase.
+   *
+   * @return const core::PresolveStats&.
+   */
+  const core::PresolveStats &getStats() const;
+
+  /**
+   * @brief Gets the solution found by postsolve, one value per
+   * column of the original problem.
+   *
+   * @return const std::vector<double>&.
+   */
+  const std::vector<double> &getFeasibleSolution() const;
+
   /**
    * @brief Prints the feasible solutions vector.
    */
@@ -85,11 +133,18 @@ public:
 
 private:
   // PRIVATE CLASS MEMBERS
-  // problem
-  const std::vector<std::vector<int>> problem_matrix_;
+  // problem. Not const as doubleton equations substitute
+  // variables out of other rows, postsolve restores the
+  // original coefficients.
+  std::vector<std::vector<int>> problem_matrix_;
   std::vector<double> lower_bounds_;
   std::vector<double> upper_bounds_;
 
+  // Constraint bounds as given, used to verify the feasible
+  // solution found in postsolve.
+  std::vector<double> original_lower_bounds_;
+  std::vector<double> original_upper_bounds_;
+
   // problem characteristics
   const int variables_count_;
   const int constraints_count_;
@@ -104,50 +159,149 @@ private:
   std::vector<double> implied_lower_bounds_;
   std::vector<double> implied_upper_bounds_;
 
+  // Minimum and maximum activity of each row over the active
+  // columns and their implied bounds. Only the finite part is
+  // summed, infinite contributions are counted separately so that
+  // activities can be updated incrementally when a bound changes.
+  std::vector<double> min_activities_;
+  std::vector<double> max_activities_;
+  std::vector<int> min_activities_inf_count_;
+  std::vector<int> max_activities_inf_count_;
+
+  // Whether any implied bound was tightened in the current
+  // presolve iteration.
+  bool implied_bounds_changed_;
+
   // feasible solution vector
   std::vector<double> feasible_solution_;
 
-  // vectors to keep track of active rows and columns
+  // Whether the values of the reduced problem's columns were
+  // given by setReducedSolution.
+  bool reduced_solution_set_;
+
+  // sets to keep track of active rows and columns
   // during presolve
-  std::vector<bool> presolve_active_rows_;
-  std::vector<bool> presolve_active_columns_;
-  int presolve_active_rows_count_;
-  int presolve_active_cols_count_;
+  ActiveSet presolve_active_rows_;
+  ActiveSet presolve_active_columns_;
 
   // Vector to check we don't apply inequality row
   // singletons presolve twice to the same inequality.
   std::vector<int> inequality_singletons_;
 
-  std::vector<bool> postsolve_active_rows_;
-  std::vector<bool> postsolve_active_cols_;
+  ActiveSet postsolve_active_rows_;
+  ActiveSet postsolve_active_cols_;
+
+  // Running activity and sum of absolute terms of each row over the
+  // columns with a postsolve value, and the number of its nonzeros
+  // whose column has no value yet. They are updated as values are
+  // set, so rows are activated and checked without rescanning them.
+  std::vector<double> postsolve_row_activities_;
+  std::vector<double> postsolve_row_magnitudes_;
+  std::vector<int> postsolve_unresolved_counts_;
+
+  // Rows each column has a nonzero in, including the rows whose
+  // coefficient postsolve restores.
+  std::vector<std::vector<int>> postsolve_cols_rows_;
 
   // Array to keep track of the non-zero active variables in each
   // row and col during presolve.
   std::vector<std::vector<int>> rows_non_zero_variables_;
   std::vector<std::vector<int>> cols_non_zeros_indices_;
 
-  // STRUCTS:
-  // struct containing the search function and update
-  // state function for a given rule (pointers).
+  // Counters gathered during presolve, and the active counts and
+  // start time of the rule currently being applied.
+  core::PresolveStats stats_;
+  int rule_start_rows_count_;
+  int rule_start_cols_count_;
+  std::chrono::steady_clock::time_point rule_start_time_;
+
+  // Flat log of the presolve rules applied, appended to in presolve
+  // and walked backwards by index in postsolve. The dependancies and
+  // values of an entry are the slice of the shared buffers from its
+  // offset up to the offset of the next entry.
+  std::vector<int> log_rule_ids_;
+  std::vector<int> log_row_indices_;
+  std::vector<int> log_col_indices_;
+  std::vector<int> log_dependancies_offsets_;
+  std::vector<int> log_values_offsets_;
+  std::vector<int> log_dependancies_;
+  std::vector<double> log_values_;
+
+  // PRIVATE METHODS
+  /**
+   * @brief Gets the time elapsed since start_time.
+   *
+   * @param start_time: time to measure from.
+   * @return std::uint64_t nanoseconds.
+   */
+  std::uint64_t getElapsedNanos(
+    const std::chrono::steady_clock::time_point start_time
+  );
+
+  /**
+   * @brief Records the active counts and time before a rule is
+   * applied, to be closed by endRule.
+   *
+   * @return void.
+   */
+  void startRule();
+
+  /**
+   * @brief Adds the time spent and rows and columns removed since
+   * startRule to the stats of a rule.
+   *
+   * @param core::PresolveRulesIds rule_id: rule that was applied.
+   * @return void.
+   */
+  void endRule(const core::PresolveRulesIds rule_id);
+
+  /**
+   * @brief Appends a rule to the postsolve log. Dependancies and
+   * values pushed onto the shared buffers afterwards belong to it.
+   *
+   * @param int row_index: row the rule removed, or -1.
+   * @param int col_index: column the rule removed, or -1.
+   * @param core::PresolveRulesIds rule_id: rule applied.
+   * @return void.
+   */
+  void logRule(const int row_index, const int col_index,
+               const core::PresolveRulesIds rule_id);
 
-  // (type definition for trying to add postsolve function
-  // to the stack)
-  // typedef void (Presolve::*member_function)(int, int);
+  /**
+   * @brief Gets the number of dependancies of a log entry.
+   *
+   * @param int log_index: index of the log entry.
+   * @return int.
+   */
+  int getLogDependanciesCount(const int log_index);
 
-  // struct to keep track of presolve rules applied
-  // during presolve.
-  struct presolve_log {
-    int constraint_index; // constraint number
-    int variable_index;   // variable (column) index
-    int rule_id;          // presolve rule function to apply in postsolve
-    std::vector<int> dependancies;
-  };
+  /**
+   * @brief Gets the k-th dependancy of a log entry.
+   *
+   * @param int log_index: index of the log entry.
+   * @param int k: index within the entry's dependancies.
+   * @return int.
+   */
+  int getLogDependancy(const int log_index, const int k);
 
-  // PRIVATE CLASS VARIABLES:
-  // stack of presolve structs.
-  std::stack<presolve_log> presolve_stack_;
+  /**
+   * @brief Gets the k-th value of a log entry.
+   *
+   * @param int log_index: index of the log entry.
+   * @param int k: index within the entry's values.
+   * @return double.
+   */
+  double getLogValue(const int log_index, const int k);
+
+  /**
+   * @brief Drops every log entry from entries_count onwards
+   * together with their dependancies and values.
+   *
+   * @param int entries_count: number of entries to keep.
+   * @return void.
+   */
+  void truncateLog(const int entries_count);
 
-  // PRIVATE METHODS
   /**
    * @brief Gets the indices of the non-zero rows (coefficients)
    * of each column and stores in the
@@ -209,15 +363,314 @@ private:
    * @param int variable_coefficient: integer coefficient of the variable.
    * @param int constraint_RHS: integer RHS of constraint.
    * @param int row_index.
-   * @return int Inf if not feasible, int feasible value if feasible.
+   * @return std::optional<int> feasible value, nothing if not feasible
+   * or past the int range, which sets overflow_.
    */
-  int getVariableFeasibleValueIP(
+  std::optional<int> getVariableFeasibleValueIP(
     const int row_index, 
     const int col_index, 
     const int variable_coefficient, 
     const double constraint_RHS
   );
 
+  /**
+   * @brief Checks if a bound is infinite.
+   *
+   * @param double value: bound to check.
+   * @return bool.
+   */
+  bool isInfinite(const double value) const;
+
+  /**
+   * @brief Checks if a value is finite and within the range in
+   * which doubles hold every integer exactly.
+   *
+   * @param double value.
+   * @return bool.
+   */
+  bool isExact(const double value) const;
+
+  /**
+   * @brief Sets overflow_ if a finite bound of a row has left the
+   * exact integer range.
+   *
+   * @param int row_index.
+   * @return void.
+   */
+  void checkRowBoundsOverflow(const int row_index);
+
+  /**
+   * @brief Adds (sign 1) or removes (sign -1) the contribution of
+   * a variable with coefficient coefficient and bounds lower_bound
+   * and upper_bound to the activities of a row.
+   *
+   * @param int row_index.
+   * @param int coefficient.
+   * @param double lower_bound.
+   * @param double upper_bound.
+   * @param int sign.
+   * @return void.
+   */
+  void updateRowActivity(
+    const int row_index, const int coefficient,
+    const double lower_bound, const double upper_bound, const int sign
+  );
+
+  /**
+   * @brief Computes the minimum and maximum activity of every row
+   * from scratch. Called once at the start of presolve, after which
+   * activities are kept up to date by updateImpliedBounds and
+   * updateStateFixedCol.
+   *
+   * @return void.
+   */
+  void computeRowActivities();
+
+  /**
+   * @brief Sets the implied bounds of a variable, updating the
+   * activities of every active row containing it.
+   *
+   * @param int col_index.
+   * @param double lower_bound: new implied lower bound.
+   * @param double upper_bound: new implied upper bound.
+   * @return void.
+   */
+  void updateImpliedBounds(
+    const int col_index, const double lower_bound, const double upper_bound
+  );
+
+  /**
+   * @brief Tightens the implied bounds of a variable to the given
+   * bounds if they are tighter. If the bounds cross the problem is
+   * set to infeasible.
+   *
+   * @param int col_index.
+   * @param double lower_bound: candidate lower bound.
+   * @param double upper_bound: candidate upper bound.
+   * @return void.
+   */
+  void tightenImpliedBounds(
+    const int col_index, const double lower_bound, const double upper_bound
+  );
+
+  /**
+   * @brief Updates state when a row with no active variables is
+   * found in presolve. The row is infeasible unless zero lies
+   * within its bounds, otherwise it is turned off and logged.
+   *
+   * @param int row_index: index of the row.
+   * @return void.
+   */
+  void updateStateEmptyRow(const int row_index);
+
+  /**
+   * @brief Checks if a row is redundant, i.e. its activity bounds
+   * lie within the row bounds so that any values within the implied
+   * bounds satisfy it.
+   *
+   * @param int row_index: index of the row.
+   * @return bool.
+   */
+  bool isRowRedundant(const int row_index);
+
+  /**
+   * @brief Updates state when a redundant row has been found in
+   * presolve. Turns off the row and logs it.
+   *
+   * @param int row_index: index of the row.
+   * @return void.
+   */
+  void updateStateRedundantRow(const int row_index);
+
+  /**
+   * @brief Updates state when a forcing row has been found in
+   * presolve, i.e. a row which can only be satisfied with every
+   * variable at the bound giving its maximum (or minimum) activity.
+   * Fixes those variables, turns off the row and logs it.
+   *
+   * @param int row_index: index of the row.
+   * @param bool at_max_activity: whether the variables are fixed at
+   * the bounds giving the maximum activity.
+   * @return void.
+   */
+  void updateStateForcingRow(const int row_index, const bool at_max_activity);
+
+  /**
+   * @brief Uses the activity bounds of a row to tighten the implied
+   * bounds of its variables. Column singletons are left untouched so
+   * that they can still be removed by free column substitution.
+   *
+   * @param int row_index: index of the row.
+   * @return void.
+   */
+  void propagateRowBounds(const int row_index);
+
+  /**
+   * @brief Checks if variable col_index can be substituted out of
+   * the problem using the equality row_index, whose other variable
+   * is other_col_index, while keeping every coefficient an integer.
+   * If solving the ip, the substituted variable must also take
+   * integer values.
+   *
+   * @param int row_index: index of the doubleton equation.
+   * @param int col_index: variable to substitute.
+   * @param int other_col_index: variable kept.
+   * @return bool.
+   */
+  bool canSubstituteDoubletonEquation(
+    const int row_index, const int col_index, const int other_col_index
+  );
+
+  /**
+   * @brief Updates state when a doubleton equation a x_j + b x_k = c
+   * has been found in presolve. x_j = (c - b x_k) / a is substituted
+   * into every other row containing it, its implied bounds are moved
+   * onto x_k, and the row and x_j are turned off. The original
+   * coefficients of x_k are logged so postsolve can restore them.
+   *
+   * @param int row_index: index of the doubleton equation.
+   * @param int col_index: variable to substitute (x_j).
+   * @param int other_col_index: variable kept (x_k).
+   * @return void.
+   */
+  void updateStateDoubletonEquation(
+    const int row_index, const int col_index, const int other_col_index
+  );
+
+  /**
+   * @brief Applies postsolve for a doubleton equation. Restores the
+   * coefficients and bounds of the rows x_j was substituted into,
+   * then recovers x_j from the value of x_k.
+   *
+   * @param int row_index: index of the doubleton equation.
+   * @param int col_index: substituted variable.
+   * @param int log_index: log entry, whose dependancies are the kept
+   * variable followed by pairs of modified row and original coefficient.
+   * @return void.
+   */
+  void applyDoubletonEquationPostsolve(
+    const int row_index, const int col_index, const int log_index
+  );
+
+  /**
+   * @brief Gets a hash of a column over the active rows, normalised
+   * by the gcd of its coefficients and the sign of its first one so
+   * that columns which are scalar multiples of each other collide.
+   *
+   * @param int col_index: index of the column.
+   * @return std::size_t hash of the normalised column.
+   */
+  std::size_t getColumnHash(const int col_index);
+
+  /**
+   * @brief Gets the ratio of a column to another one over the
+   * active rows, that is s with a_k = s a_j.
+   *
+   * @param int col_index: index of the column x_j.
+   * @param int other_col_index: index of the column x_k.
+   * @return double ratio, or 0 if the columns are not parallel.
+   */
+  double getParallelColRatio(const int col_index, const int other_col_index);
+
+  /**
+   * @brief Checks if x_k with a_k = s a_j can be merged into x_j.
+   * Always possible for the lp. For the ip s must be an integer and
+   * x_j must cover every gap between multiples of s, so that every
+   * integer x_j + s x_k is reached.
+   *
+   * @param int col_index: index of the kept column x_j.
+   * @param int other_col_index: index of the merged column x_k.
+   * @param double ratio: s.
+   * @return bool.
+   */
+  bool canMergeParallelCols(
+    const int col_index, const int other_col_index, const double ratio
+  );
+
+  /**
+   * @brief Updates state when columns with a_k = s a_j have been
+   * found in presolve. x_j is replaced by x_j + s x_k, taking the
+   * sum of the bounds, and x_k is turned off. The old bounds of x_j
+   * are logged so postsolve can split the merged value again.
+   *
+   * @param int col_index: index of the kept column x_j.
+   * @param int other_col_index: index of the merged column x_k.
+   * @param double ratio: s.
+   * @return void.
+   */
+  void updateStateParallelCol(
+    const int col_index, const int other_col_index, const double ratio
+  );
+
+  /**
+   * @brief Applies postsolve for parallel columns. Splits the value
+   * of x_j + s x_k back into values of x_j and x_k within their
+   * bounds.
+   *
+   * @param int col_index: index of the kept column x_j.
+   * @param int log_index: log entry, whose dependancy is the merged
+   * column x_k and whose values are s and the old bounds of x_j.
+   * @return void.
+   */
+  void applyParallelColPostsolve(const int col_index, const int log_index);
+
+  /**
+   * @brief Gets the direction in which a column is dominated. With no
+   * objective, a column is dominated upwards if increasing it cannot
+   * violate any active row, that is every row where it has a positive
+   * coefficient has no upper bound and every row where it has a
+   * negative one has no lower bound, and downwards the other way round.
+   *
+   * @param int col_index: index of the column.
+   * @return int 1 if dominated upwards, -1 if downwards, 0 if not.
+   */
+  int getDominatedColDirection(const int col_index);
+
+  /**
+   * @brief Updates state when a column is dominated. If the bound in
+   * the dominated direction is finite the column is fixed there,
+   * otherwise the column and every row containing it are turned off,
+   * since the column can always be moved far enough to satisfy them.
+   *
+   * @param int col_index: index of the column.
+   * @param int direction: direction the column is dominated in.
+   * @return void.
+   */
+  void updateStateDominatedCol(const int col_index, const int direction);
+
+  /**
+   * @brief Applies postsolve for a dominated column removed with its
+   * rows. The column takes the value closest to its bounds which
+   * satisfies all the removed rows.
+   *
+   * @param int col_index: index of the column.
+   * @param int log_index: log entry, whose dependancies are the
+   * direction the column is dominated in followed by the removed rows.
+   * @return void.
+   */
+  void applyDominatedColPostsolve(const int col_index, const int log_index);
+
+  /**
+   * @brief Applies postsolve for a row removed as empty, redundant
+   * or forcing: once all its variables have feasible values the
+   * constraint is checked and the row turned on.
+   *
+   * @param int row_index: index of the row.
+   * @param int rule_id: rule which removed the row.
+   * @return void.
+   */
+  void applyRemovedRowPostsolve(const int row_index, const int rule_id);
+
+  /**
+   * @brief Checks the feasible solution found in postsolve against
+   * every constraint with its original bounds, setting
+   * unsatisfied_constraints_ if any is violated or any variable has
+   * no value.
+   *
+   * @return void.
+   */
+  void checkFeasibleSolution();
+
   /**
    * @brief Checks if a row is free, that is if it has lower
    * bound of minus infinity and upper bound of infinity.
@@ -343,21 +796,36 @@ private:
 
 
   /**
-   * @brief Checks if two parallel rows are feasible. Check project
-   * report for on how the checks work.
+   * @brief Gets the bounds the large row of a pair of parallel rows
+   * puts on the small row, rounded inwards if solving the ip.
+   *
+   * @param int large_row_index: index of row with larger
+   * coefficients.
+   * @param double large_to_small_ratio: ratio of large row (larger
+   * coefficients) to small row.
+   *
+   * @return std::vector<double> lower and upper bound.
+   */
+  std::vector<double> getParallelRowBoundsOnSmallRow(const int large_row_index,
+                                                     const double large_to_small_ratio);
+
+  /**
+   * @brief Checks if two parallel rows are feasible, that is if the
+   * bounds of the large row divided by the ratio overlap with the
+   * bounds of the small row.
    *
    * @param int small_row_index: index of row with smaller 
    * coefficients.
-   * @param int large_to_small_ratio: ratio of large row (larger coefficients)
+   * @param int large_row_index: index of row with larger
+   * coefficients.
+   * @param double large_to_small_ratio: ratio of large row (larger coefficients)
    * to small row.
-   * @param double large_bound_by_ratio: ratio of upper bound of large row
-   * divided by large_to_small_ratio.
    * 
    * @return bool.
    */
   bool checkAreParallelRowsFeasible(const int small_row_index,
-                                    const int large_to_small_ratio,
-                                    const double large_bound_by_ratio);
+                                    const int large_row_index,
+                                    const double large_to_small_ratio);
 
   /**
    * @brief Updates state of the problem when parallel rows are 
@@ -367,17 +835,14 @@ private:
    * coefficients.
    * @param int large_row_index: index of row with larger
    * coefficients.
-   * @param int large_to_small_ratio: ratio of large row (larger coefficients)
+   * @param double large_to_small_ratio: ratio of large row (larger coefficients)
    * to small row.
-   * @param double large_bound_by_ratio: ratio of upper bound of large row
-   * divided by large_to_small_ratio.
    * 
    * @return void.
    */
   void updateStateParallelRow(const int small_row_index,
                               const int large_row_index,
-                              const double large_to_small_ratio,
-                              const double large_bound_by_ratio);
+                              const double large_to_small_ratio);
 
   /**
    * @brief Applies postsolve for a row that had been removed
@@ -437,10 +902,11 @@ private:
    * the feasible solution vector. It does not turn the column
    *
    * @param col_index: column index.
+   * @param log_index: log entry, whose dependancies are the rows
+   * containing the column when it was fixed.
    * @return void.
    */
-  void applyFixedColPostsolve(const int col_index,
-                              const std::vector<int> col_non_zeros);
+  void applyFixedColPostsolve(const int col_index, const int log_index);
 
   /**
    * @brief Checks if a column, which has already been found to be
@@ -510,6 +976,34 @@ private:
    */
   void applyPresolveColRules();
 
+  /**
+   * @brief Applies the activity based rules to the problem during
+   * a presolve iteration: infeasibility, redundant and forcing rows,
+   * and bound propagation.
+   *
+   * @return void.
+   */
+  void applyPresolveActivityRules();
+
+  /**
+   * @brief Applies the parallel column rule during a presolve
+   * iteration. Columns are bucketed by getColumnHash and only columns
+   * in the same bucket are compared.
+   *
+   * @return void.
+   */
+  void applyPresolveParallelColRules();
+
+  /**
+   * @brief Applies doubleton equation elimination during a presolve
+   * iteration. Run last, since substitutions change the nonzeros of
+   * other rows; rows and columns already changed in this pass are
+   * skipped until the next iteration.
+   *
+   * @return void.
+   */
+  void applyPresolveDoubletonRules();
+
   /**
    * @brief Checks if the feasible value that has been found for
    * a varibale satisfies the variable's implied bounds.
@@ -523,6 +1017,42 @@ private:
   bool checkVariableImpliedBounds(const int col_index,
                                   const int feasible_value);
 
+  /**
+   * @brief Returns the value closest to value within the implied
+   * bounds of a variable.
+   *
+   * @param int col_index: index of the variable.
+   * @param double value.
+   * @return double.
+   */
+  double clampToImpliedBounds(const int col_index, const double value);
+
+  /**
+   * @brief Sets up the running row activities and unresolved
+   * counts of postsolve from the matrix left by presolve.
+   */
+  void initPostsolveActivities();
+
+  /**
+   * @brief Sets the postsolve value of a variable, activating it
+   * if needed, and updates the activities of its rows.
+   *
+   * @param int col_index: index of the variable.
+   * @param double value.
+   */
+  void setPostsolveValue(const int col_index, const double value);
+
+  /**
+   * @brief Restores a coefficient of the matrix in postsolve and
+   * updates the activity or unresolved count of its row.
+   *
+   * @param int row_index: index of the row.
+   * @param int col_index: index of the variable.
+   * @param int coefficient: restored coefficient.
+   */
+  void setPostsolveCoefficient(const int row_index, const int col_index,
+                               const int coefficient);
+
   /**
    * @brief Checks if a row is active in postsolve, that is,
    * if we have found feasible values for all its nonzero
@@ -0,0 +1,84 @@
+#include "parallel_for.hpp"
+
+namespace solvers::pdhg {
+
+ParallelFor::ParallelFor(const int num_threads)
+    : num_threads_(num_threads < 1 ? 1 : num_threads), body_(nullptr),
+      size_(0), generation_(0), num_pending_chunks_(0), is_stopping_(false) {}
+
+ParallelFor::~ParallelFor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  start_condition_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+int ParallelFor::getNumThreads() { return num_threads_; }
+
+void ParallelFor::runChunk(const int chunk) {
+  const long long begin =
+      static_cast<long long>(size_) * chunk / num_threads_;
+  const long long end =
+      static_cast<long long>(size_) * (chunk + 1) / num_threads_;
+  if (begin < end) {
+    (*body_)(static_cast<int>(begin), static_cast<int>(end));
+  }
+}
+
+void ParallelFor::workerLoop(const int chunk) {
+  long long seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_condition_.wait(lock, [&] {
+        return is_stopping_ || generation_ != seen_generation;
+      });
+      if (is_stopping_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+
+    runChunk(chunk);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_pending_chunks_ == 0) {
+      done_condition_.notify_one();
+    }
+  }
+}
+
+void ParallelFor::run(const int size,
+                      const std::function<void(int, int)> &body) {
+  if (num_threads_ == 1) {
+    body(0, size);
+    return;
+  }
+  // started by the first loop, so that solvers that never split one start
+  // no threads
+  if (workers_.empty()) {
+    for (int chunk = 1; chunk < num_threads_; ++chunk) {
+      workers_.emplace_back(&ParallelFor::workerLoop, this, chunk);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    body_ = &body;
+    size_ = size;
+    num_pending_chunks_ = num_threads_ - 1;
+    ++generation_;
+  }
+  start_condition_.notify_all();
+
+  runChunk(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [&] { return num_pending_chunks_ == 0; });
+}
+
+} // namespace solvers::pdhg
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace solvers::pdhg {
+
+/**
+ * @brief Fixed pool of worker threads splitting a loop into contiguous
+ * chunks, one per thread. The threads are started by the first loop and wait
+ * between loops, so a loop costs a wake up rather than a thread start
+ */
+class ParallelFor {
+public:
+  /**
+   * @brief num_threads - 1 workers are started on the first run(), the
+   * calling thread runs the first chunk of every loop
+   *
+   * @param num_threads
+   */
+  explicit ParallelFor(const int num_threads);
+
+  ~ParallelFor();
+
+  ParallelFor(const ParallelFor &) = delete;
+  ParallelFor &operator=(const ParallelFor &) = delete;
+
+  /**
+   * @brief runs body(begin, end) over chunks covering [0, size) and returns
+   * once every chunk is done
+   *
+   * @param size
+   * @param body
+   */
+  void run(const int size, const std::function<void(int, int)> &body);
+
+  /**
+   * @brief returns the number of threads loops are split over
+   *
+   * @return int
+   */
+  int getNumThreads();
+
+private:
+  int num_threads_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable start_condition_;
+  std::condition_variable done_condition_;
+
+  // loop being run, a new generation wakes the workers up
+  const std::function<void(int, int)> *body_;
+  int size_;
+  long long generation_;
+  int num_pending_chunks_;
+  bool is_stopping_;
+
+  void runChunk(const int chunk);
+
+  void workerLoop(const int chunk);
+};
+
+} // namespace solvers::pdhg
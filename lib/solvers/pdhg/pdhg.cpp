@@ -0,0 +1,464 @@
+#include "pdhg.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace solvers::pdhg {
+
+namespace {
+
+int getNumThreads() {
+  const int num_hardware_threads = std::thread::hardware_concurrency();
+  return std::max(1, std::min(num_hardware_threads, core::kPdhgMaxThreads));
+}
+
+} // namespace
+
+PrimalDualHybridGradient::PrimalDualHybridGradient()
+    : num_variables_(0), num_rows_(0), num_inequality_rows_(0),
+      parallel_(getNumThreads()), average_weight_(0), restart_kkt_error_(0),
+      previous_candidate_kkt_error_(0), restart_iteration_(0), step_size_(0),
+      primal_weight_(1), iteration_count_(0) {}
+
+std::vector<double> PrimalDualHybridGradient::getSolution() {
+  return solution_;
+}
+
+int PrimalDualHybridGradient::getIterationCount() { return iteration_count_; }
+
+void PrimalDualHybridGradient::setProblem(const core::InputRows &problem) {
+  // the reader counts the constant term as a variable
+  num_variables_ = problem.num_variables - 1;
+  num_inequality_rows_ = problem.inequality_rows.size();
+  num_rows_ = num_inequality_rows_ + problem.equality_rows.size();
+
+  row_starts_.assign(num_rows_ + 1, 0);
+  row_columns_.clear();
+  row_values_.clear();
+  bounds_.resize(num_rows_);
+  column_starts_.assign(num_variables_ + 1, 0);
+  for (int i = 0; i < num_rows_; ++i) {
+    const std::vector<float> &row =
+        i < num_inequality_rows_
+            ? problem.inequality_rows.at(i)
+            : problem.equality_rows.at(i - num_inequality_rows_);
+    row_starts_.at(i) = row_columns_.size();
+    bounds_.at(i) = -row.at(0);
+    for (int j = 0; j < num_variables_; ++j) {
+      if (row.at(j + 1) != 0) {
+        row_columns_.push_back(j);
+        row_values_.push_back(row.at(j + 1));
+        ++column_starts_.at(j + 1);
+      }
+    }
+  }
+  row_starts_.at(num_rows_) = row_columns_.size();
+  for (int j = 0; j < num_variables_; ++j) {
+    column_starts_.at(j + 1) += column_starts_.at(j);
+  }
+
+  scaleProblem();
+
+  primal_.resize(num_variables_);
+  dual_.resize(num_rows_);
+  primal_product_.resize(num_rows_);
+  dual_product_.resize(num_variables_);
+  next_primal_.resize(num_variables_);
+  next_dual_.resize(num_rows_);
+  next_primal_product_.resize(num_rows_);
+  next_dual_product_.resize(num_variables_);
+  average_primal_.resize(num_variables_);
+  average_dual_.resize(num_rows_);
+  average_primal_product_.resize(num_rows_);
+  average_dual_product_.resize(num_variables_);
+  restart_primal_.resize(num_variables_);
+  restart_dual_.resize(num_rows_);
+  checked_dual_.resize(num_rows_);
+}
+
+void PrimalDualHybridGradient::scaleProblem() {
+  scaled_row_values_ = row_values_;
+  row_scaling_.assign(num_rows_, 1);
+  column_scaling_.assign(num_variables_, 1);
+
+  std::vector<double> row_factors(num_rows_);
+  std::vector<double> column_factors(num_variables_);
+  const auto apply_factors = [&]() {
+    for (int i = 0; i < num_rows_; ++i) {
+      row_scaling_.at(i) *= row_factors.at(i);
+      for (int p = row_starts_.at(i); p < row_starts_.at(i + 1); ++p) {
+        scaled_row_values_.at(p) *=
+            row_factors.at(i) * column_factors.at(row_columns_.at(p));
+      }
+    }
+    for (int j = 0; j < num_variables_; ++j) {
+      column_scaling_.at(j) *= column_factors.at(j);
+    }
+  };
+
+  // ruiz: divide rows and columns by the square root of their largest entry
+  for (int pass = 0; pass < core::kPdhgRuizIterations; ++pass) {
+    std::fill(row_factors.begin(), row_factors.end(), 0);
+    std::fill(column_factors.begin(), column_factors.end(), 0);
+    for (int i = 0; i < num_rows_; ++i) {
+      for (int p = row_starts_.at(i); p < row_starts_.at(i + 1); ++p) {
+        const double value = std::fabs(scaled_row_values_.at(p));
+        row_factors.at(i) = std::max(row_factors.at(i), value);
+        column_factors.at(row_columns_.at(p)) =
+            std::max(column_factors.at(row_columns_.at(p)), value);
+      }
+    }
+    for (double &factor : row_factors) {
+      factor = factor > 0 ? 1 / std::sqrt(factor) : 1;
+    }
+    for (double &factor : column_factors) {
+      factor = factor > 0 ? 1 / std::sqrt(factor) : 1;
+    }
+    apply_factors();
+  }
+
+  // pock-chambolle: divide by the square root of the absolute sums
+  std::fill(row_factors.begin(), row_factors.end(), 0);
+  std::fill(column_factors.begin(), column_factors.end(), 0);
+  for (int i = 0; i < num_rows_; ++i) {
+    for (int p = row_starts_.at(i); p < row_starts_.at(i + 1); ++p) {
+      const double value = std::fabs(scaled_row_values_.at(p));
+      row_factors.at(i) += value;
+      column_factors.at(row_columns_.at(p)) += value;
+    }
+  }
+  for (double &factor : row_factors) {
+    factor = factor > 0 ? 1 / std::sqrt(factor) : 1;
+  }
+  for (double &factor : column_factors) {
+    factor = factor > 0 ? 1 / std::sqrt(factor) : 1;
+  }
+  apply_factors();
+
+  scaled_bounds_.resize(num_rows_);
+  for (int i = 0; i < num_rows_; ++i) {
+    scaled_bounds_.at(i) = row_scaling_.at(i) * bounds_.at(i);
+  }
+
+  // the scaled matrix column wise
+  column_rows_.resize(row_columns_.size());
+  scaled_column_values_.resize(row_columns_.size());
+  std::vector<int> next(column_starts_.begin(), column_starts_.end() - 1);
+  for (int i = 0; i < num_rows_; ++i) {
+    for (int p = row_starts_.at(i); p < row_starts_.at(i + 1); ++p) {
+      const int q = next.at(row_columns_.at(p))++;
+      column_rows_.at(q) = i;
+      scaled_column_values_.at(q) = scaled_row_values_.at(p);
+    }
+  }
+}
+
+void PrimalDualHybridGradient::multiply(const std::vector<double> &primal,
+                                        std::vector<double> &result) {
+  const auto multiply_rows = [&](const int begin, const int end) {
+    for (int i = begin; i < end; ++i) {
+      double value = 0;
+      for (int p = row_starts_[i]; p < row_starts_[i + 1]; ++p) {
+        value += scaled_row_values_[p] * primal[row_columns_[p]];
+      }
+      result[i] = value;
+    }
+  };
+  if (static_cast<int>(row_columns_.size()) >= core::kPdhgParallelNonzeros) {
+    parallel_.run(num_rows_, multiply_rows);
+  } else {
+    multiply_rows(0, num_rows_);
+  }
+}
+
+void PrimalDualHybridGradient::multiplyTransposed(
+    const std::vector<double> &dual, std::vector<double> &result) {
+  const auto multiply_columns = [&](const int begin, const int end) {
+    for (int j = begin; j < end; ++j) {
+      double value = 0;
+      for (int p = column_starts_[j]; p < column_starts_[j + 1]; ++p) {
+        value += scaled_column_values_[p] * dual[column_rows_[p]];
+      }
+      result[j] = value;
+    }
+  };
+  if (static_cast<int>(row_columns_.size()) >= core::kPdhgParallelNonzeros) {
+    parallel_.run(num_variables_, multiply_columns);
+  } else {
+    multiply_columns(0, num_variables_);
+  }
+}
+
+void PrimalDualHybridGradient::takeStep() {
+  while (true) {
+    // x+ = x + tau A^T y and y+ = proj(y + sigma (b - A (2 x+ - x))), the
+    // projection keeping the duals of inequalities nonnegative
+    const double primal_step = step_size_ / primal_weight_;
+    const double dual_step = step_size_ * primal_weight_;
+    for (int j = 0; j < num_variables_; ++j) {
+      next_primal_[j] = primal_[j] + primal_step * dual_product_[j];
+    }
+    multiply(next_primal_, next_primal_product_);
+    for (int i = 0; i < num_rows_; ++i) {
+      double value =
+          dual_[i] + dual_step * (scaled_bounds_[i] -
+                                  2 * next_primal_product_[i] +
+                                  primal_product_[i]);
+      if (i < num_inequality_rows_) {
+        value = std::max(value, 0.0);
+      }
+      next_dual_[i] = value;
+    }
+    multiplyTransposed(next_dual_, next_dual_product_);
+    ++iteration_count_;
+
+    // the step is accepted if it is below the limit the curvature of this
+    // step allows
+    double primal_movement = 0;
+    double interaction = 0;
+    for (int j = 0; j < num_variables_; ++j) {
+      const double change = next_primal_[j] - primal_[j];
+      primal_movement += change * change;
+      interaction += change * (next_dual_product_[j] - dual_product_[j]);
+    }
+    double dual_movement = 0;
+    for (int i = 0; i < num_rows_; ++i) {
+      const double change = next_dual_[i] - dual_[i];
+      dual_movement += change * change;
+    }
+    const double movement = 0.5 * primal_weight_ * primal_movement +
+                            0.5 * dual_movement / primal_weight_;
+    const double step_limit = std::fabs(interaction) > 0
+                                  ? movement / std::fabs(interaction)
+                                  : std::numeric_limits<double>::infinity();
+    const double accepted_step = step_size_;
+    step_size_ = std::min(
+        (1 - std::pow(iteration_count_ + 1, -0.3)) * step_limit,
+        (1 + std::pow(iteration_count_ + 1, -0.6)) * step_size_);
+
+    if (accepted_step <= step_limit) {
+      primal_.swap(next_primal_);
+      dual_.swap(next_dual_);
+      primal_product_.swap(next_primal_product_);
+      dual_product_.swap(next_dual_product_);
+      for (int j = 0; j < num_variables_; ++j) {
+        average_primal_[j] += accepted_step * primal_[j];
+        average_dual_product_[j] += accepted_step * dual_product_[j];
+      }
+      for (int i = 0; i < num_rows_; ++i) {
+        average_dual_[i] += accepted_step * dual_[i];
+        average_primal_product_[i] += accepted_step * primal_product_[i];
+      }
+      average_weight_ += accepted_step;
+      return;
+    }
+  }
+}
+
+double PrimalDualHybridGradient::getKktError(
+    const std::vector<double> &dual, const std::vector<double> &primal_product,
+    const std::vector<double> &dual_product) {
+  // the objective is zero, so the gap is the dual objective b^T y and the
+  // dual residual is A^T y
+  double primal_residual = 0;
+  double gap = 0;
+  for (int i = 0; i < num_rows_; ++i) {
+    double residual = scaled_bounds_[i] - primal_product[i];
+    if (i < num_inequality_rows_) {
+      residual = std::max(residual, 0.0);
+    }
+    primal_residual += residual * residual;
+    gap += scaled_bounds_[i] * dual[i];
+  }
+  double dual_residual = 0;
+  for (int j = 0; j < num_variables_; ++j) {
+    dual_residual += dual_product[j] * dual_product[j];
+  }
+  return std::sqrt(primal_residual + dual_residual + gap * gap);
+}
+
+void PrimalDualHybridGradient::checkRestart() {
+  // the average is held as sums, next_ buffers are free between steps
+  for (int j = 0; j < num_variables_; ++j) {
+    next_primal_[j] = average_primal_[j] / average_weight_;
+    next_dual_product_[j] = average_dual_product_[j] / average_weight_;
+  }
+  for (int i = 0; i < num_rows_; ++i) {
+    next_dual_[i] = average_dual_[i] / average_weight_;
+    next_primal_product_[i] = average_primal_product_[i] / average_weight_;
+  }
+  const double current_kkt_error =
+      getKktError(dual_, primal_product_, dual_product_);
+  const double average_kkt_error =
+      getKktError(next_dual_, next_primal_product_, next_dual_product_);
+  const bool is_average_better = average_kkt_error < current_kkt_error;
+  const double candidate_kkt_error =
+      is_average_better ? average_kkt_error : current_kkt_error;
+
+  // restart on a large enough drop, on a smaller drop that has stopped
+  // improving, or after a long time without a restart
+  const bool is_restarting =
+      candidate_kkt_error <=
+          core::kPdhgSufficientRestartFactor * restart_kkt_error_ ||
+      (candidate_kkt_error <=
+           core::kPdhgNecessaryRestartFactor * restart_kkt_error_ &&
+       candidate_kkt_error > previous_candidate_kkt_error_) ||
+      iteration_count_ - restart_iteration_ >=
+          core::kPdhgArtificialRestartFactor * iteration_count_;
+  previous_candidate_kkt_error_ = candidate_kkt_error;
+  if (!is_restarting) {
+    return;
+  }
+
+  if (is_average_better) {
+    primal_.swap(next_primal_);
+    dual_.swap(next_dual_);
+    primal_product_.swap(next_primal_product_);
+    dual_product_.swap(next_dual_product_);
+  }
+
+  // balance the primal weight with the distances moved since the last
+  // restart, smoothed in log scale
+  double primal_distance = 0;
+  double dual_distance = 0;
+  for (int j = 0; j < num_variables_; ++j) {
+    const double change = primal_[j] - restart_primal_[j];
+    primal_distance += change * change;
+  }
+  for (int i = 0; i < num_rows_; ++i) {
+    const double change = dual_[i] - restart_dual_[i];
+    dual_distance += change * change;
+  }
+  primal_distance = std::sqrt(primal_distance);
+  dual_distance = std::sqrt(dual_distance);
+  if (primal_distance > core::kPdhgTolerance &&
+      dual_distance > core::kPdhgTolerance) {
+    primal_weight_ = std::exp(0.5 * std::log(dual_distance / primal_distance) +
+                              0.5 * std::log(primal_weight_));
+  }
+
+  restart_primal_ = primal_;
+  restart_dual_ = dual_;
+  restart_kkt_error_ = candidate_kkt_error;
+  restart_iteration_ = iteration_count_;
+  std::fill(average_primal_.begin(), average_primal_.end(), 0);
+  std::fill(average_dual_.begin(), average_dual_.end(), 0);
+  std::fill(average_primal_product_.begin(), average_primal_product_.end(), 0);
+  std::fill(average_dual_product_.begin(), average_dual_product_.end(), 0);
+  average_weight_ = 0;
+}
+
+bool PrimalDualHybridGradient::isFeasible(const std::vector<double> &primal) {
+  solution_.resize(num_variables_);
+  for (int j = 0; j < num_variables_; ++j) {
+    solution_[j] = column_scaling_[j] * primal[j];
+  }
+  for (int i = 0; i < num_rows_; ++i) {
+    double activity = 0;
+    for (int p = row_starts_[i]; p < row_starts_[i + 1]; ++p) {
+      activity += row_values_[p] * solution_[row_columns_[p]];
+    }
+    const double residual = activity - bounds_[i];
+    if (residual < -core::kFeasibilityTolerance ||
+        (i >= num_inequality_rows_ &&
+         residual > core::kFeasibilityTolerance)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PrimalDualHybridGradient::isFarkasRay(const std::vector<double> &dual) {
+  // unscaled ray y_i = r_i y'_i, clipped to be nonnegative on inequalities
+  std::vector<double> &ray = next_dual_;
+  double ray_norm = 0;
+  double ray_objective = 0;
+  for (int i = 0; i < num_rows_; ++i) {
+    double value = row_scaling_[i] * dual[i];
+    if (i < num_inequality_rows_) {
+      value = std::max(value, 0.0);
+    }
+    ray[i] = value;
+    ray_norm = std::max(ray_norm, std::fabs(value));
+    ray_objective += bounds_[i] * value;
+  }
+  if (ray_norm == 0 || ray_objective < core::kFeasibilityTolerance * ray_norm) {
+    return false;
+  }
+
+  // A^T y = 0 with the unscaled matrix
+  for (int j = 0; j < num_variables_; ++j) {
+    double value = 0;
+    for (int p = column_starts_[j]; p < column_starts_[j + 1]; ++p) {
+      value += scaled_column_values_[p] /
+               (row_scaling_[column_rows_[p]] * column_scaling_[j]) *
+               ray[column_rows_[p]];
+    }
+    if (std::fabs(value) > core::kPdhgTolerance * ray_norm) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PrimalDualHybridGradient::isInfeasible() {
+  // the duals diverge along a ray on infeasible problems, so both they and
+  // their change since the last check approach one
+  if (isFarkasRay(dual_)) {
+    return true;
+  }
+  for (int i = 0; i < num_rows_; ++i) {
+    checked_dual_[i] = dual_[i] - checked_dual_[i];
+  }
+  const bool is_infeasible = isFarkasRay(checked_dual_);
+  checked_dual_ = dual_;
+  return is_infeasible;
+}
+
+core::SolveStatus PrimalDualHybridGradient::solveProblem() {
+  std::fill(primal_.begin(), primal_.end(), 0);
+  std::fill(dual_.begin(), dual_.end(), 0);
+  std::fill(primal_product_.begin(), primal_product_.end(), 0);
+  std::fill(dual_product_.begin(), dual_product_.end(), 0);
+  std::fill(average_primal_.begin(), average_primal_.end(), 0);
+  std::fill(average_dual_.begin(), average_dual_.end(), 0);
+  std::fill(average_primal_product_.begin(), average_primal_product_.end(), 0);
+  std::fill(average_dual_product_.begin(), average_dual_product_.end(), 0);
+  std::fill(restart_primal_.begin(), restart_primal_.end(), 0);
+  std::fill(restart_dual_.begin(), restart_dual_.end(), 0);
+  std::fill(checked_dual_.begin(), checked_dual_.end(), 0);
+  average_weight_ = 0;
+  iteration_count_ = 0;
+  restart_iteration_ = 0;
+  primal_weight_ = 1;
+
+  if (isFeasible(primal_)) {
+    return core::SolveStatus::kFeasible;
+  }
+
+  // the largest entry bounds the norm of the scaled matrix from below
+  double max_entry = 0;
+  for (const double value : scaled_row_values_) {
+    max_entry = std::max(max_entry, std::fabs(value));
+  }
+  step_size_ = 1 / max_entry;
+  restart_kkt_error_ = getKktError(dual_, primal_product_, dual_product_);
+  previous_candidate_kkt_error_ = restart_kkt_error_;
+
+  while (iteration_count_ < core::kPdhgMaxIterations) {
+    takeStep();
+    if (iteration_count_ % core::kPdhgCheckFrequency != 0) {
+      continue;
+    }
+    if (isFeasible(primal_)) {
+      return core::SolveStatus::kFeasible;
+    }
+    if (isInfeasible()) {
+      return core::SolveStatus::kInfeasible;
+    }
+    checkRestart();
+  }
+  return core::SolveStatus::kDidntConverge;
+}
+
+} // namespace solvers::pdhg
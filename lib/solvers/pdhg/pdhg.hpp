@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+#include "parallel_for.hpp"
+
+namespace solvers::pdhg {
+
+/**
+ * @brief Matrix free primal-dual hybrid gradient method in the style of
+ * PDLP, for rows a x + c >= 0 and a x + c = 0 over free x. It only needs
+ * products with the matrix and its transpose, which are split over threads
+ * once the matrix is large enough, so memory stays linear in the nonzeros.
+ *
+ * The rows are rescaled by a few Ruiz passes and Pock-Chambolle scaling, the
+ * step size is adapted to the local curvature, and the iterates are
+ * restarted from their average when its KKT error has dropped far enough.
+ * The verdict is residual based: feasible once x satisfies every original
+ * row within kFeasibilityTolerance, infeasible once the change of the duals
+ * between checks is a Farkas ray within kPdhgTolerance
+ */
+class PrimalDualHybridGradient {
+public:
+  PrimalDualHybridGradient();
+
+  /**
+   * @brief Set the problem to be solved
+   *
+   * @param problem problem as returned by the reader
+   */
+  void setProblem(const core::InputRows &problem);
+
+  /**
+   * @brief Iterate until a verdict, returning kDidntConverge after
+   * kPdhgMaxIterations
+   *
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem();
+
+  /**
+   * @brief returns the point found by the last feasible solve
+   *
+   * @return std::vector<double>
+   */
+  std::vector<double> getSolution();
+
+  /**
+   * @brief returns the number of iterations of the last solve
+   *
+   * @return int
+   */
+  int getIterationCount();
+
+private:
+  int num_variables_;
+  int num_rows_;
+  int num_inequality_rows_;
+
+  // the matrix row wise and column wise, as given and scaled, with the right
+  // hand side -c of each row. Inequalities come first
+  std::vector<int> row_starts_;
+  std::vector<int> row_columns_;
+  std::vector<double> row_values_;
+  std::vector<double> scaled_row_values_;
+  std::vector<int> column_starts_;
+  std::vector<int> column_rows_;
+  std::vector<double> scaled_column_values_;
+  std::vector<double> bounds_;
+  std::vector<double> scaled_bounds_;
+
+  // x = column_scaling_ x' and the scaled rows are row_scaling_ a_i
+  std::vector<double> row_scaling_;
+  std::vector<double> column_scaling_;
+
+  ParallelFor parallel_;
+
+  // current iterates with their products, the next ones, their step size
+  // weighted averages and the point of the last restart
+  std::vector<double> primal_;
+  std::vector<double> dual_;
+  std::vector<double> primal_product_;
+  std::vector<double> dual_product_;
+  std::vector<double> next_primal_;
+  std::vector<double> next_dual_;
+  std::vector<double> next_primal_product_;
+  std::vector<double> next_dual_product_;
+  std::vector<double> average_primal_;
+  std::vector<double> average_dual_;
+  std::vector<double> average_primal_product_;
+  std::vector<double> average_dual_product_;
+  double average_weight_;
+  std::vector<double> restart_primal_;
+  std::vector<double> restart_dual_;
+  double restart_kkt_error_;
+  double previous_candidate_kkt_error_;
+  int restart_iteration_;
+
+  // duals at the last check, their change is tested as a Farkas ray
+  std::vector<double> checked_dual_;
+
+  double step_size_;
+  double primal_weight_;
+  int iteration_count_;
+  std::vector<double> solution_;
+
+  /**
+   * @brief Ruiz equilibration then Pock-Chambolle scaling of the rows and
+   * columns
+   *
+   */
+  void scaleProblem();
+
+  /**
+   * @brief result = A' x for the scaled matrix, rows split over threads
+   *
+   * @param primal
+   * @param result
+   */
+  void multiply(const std::vector<double> &primal, std::vector<double> &result);
+
+  /**
+   * @brief result = A'^T y, columns split over threads
+   *
+   * @param dual
+   * @param result
+   */
+  void multiplyTransposed(const std::vector<double> &dual,
+                          std::vector<double> &result);
+
+  /**
+   * @brief one step with the adaptive step size: steps are retried with a
+   * smaller size until they satisfy the curvature bound
+   *
+   */
+  void takeStep();
+
+  /**
+   * @brief returns the KKT error of a scaled point from its products
+   *
+   * @param dual
+   * @param primal_product A' x
+   * @param dual_product A'^T y
+   * @return double
+   */
+  double getKktError(const std::vector<double> &dual,
+                     const std::vector<double> &primal_product,
+                     const std::vector<double> &dual_product);
+
+  /**
+   * @brief restarts from the average or the current point when the KKT error
+   * has dropped enough, updating the primal weight
+   *
+   */
+  void checkRestart();
+
+  /**
+   * @brief checks a scaled point against every original row, filling
+   * solution_ with its unscaled values
+   *
+   * @param primal
+   * @return bool
+   */
+  bool isFeasible(const std::vector<double> &primal);
+
+  /**
+   * @brief checks whether scaled duals unscale to a Farkas ray: nonnegative
+   * on inequalities, A^T y = 0 and b^T y > 0
+   *
+   * @param dual
+   * @return bool
+   */
+  bool isFarkasRay(const std::vector<double> &dual);
+
+  /**
+   * @brief checks the duals and their change since the last check for a
+   * Farkas ray
+   *
+   * @return bool
+   */
+  bool isInfeasible();
+};
+
+} // namespace solvers::pdhg
@@ -0,0 +1,86 @@
+#include "policy_tuner.hpp"
+
+namespace solvers::pipeline {
+
+const std::vector<std::string> PolicyTuner::kCandidatePipelines = {
+    SelectionPolicy::kDefaultPipeline,
+    "tiny,dual,primal",
+    "dual,primal",
+    "presolve,fourier_motzkin,tiny,dual,primal",
+    "fourier_motzkin,tiny,dual,primal",
+    "interior_point,presolve,tiny,dual,primal"};
+
+PolicyTuner::PolicyTuner(const std::vector<std::string> &candidates)
+    : candidates_(candidates) {}
+
+const std::vector<std::string> &PolicyTuner::getCandidates() const {
+  return candidates_;
+}
+
+void PolicyTuner::addSample(
+    const SelectionPolicy::Bucket &bucket,
+    const std::vector<std::uint64_t> &times_nanos,
+    const std::vector<core::SolveStatus> &solve_statuses) {
+  BucketTotals &totals = totals_[bucket];
+  if (totals.num_samples == 0) {
+    totals.time_nanos.assign(candidates_.size(), 0);
+    totals.is_valid.assign(candidates_.size(), true);
+  }
+  ++totals.num_samples;
+  for (std::size_t c = 0; c < candidates_.size(); ++c) {
+    totals.time_nanos.at(c) += times_nanos.at(c);
+    if (solve_statuses.at(c) != solve_statuses.at(0)) {
+      totals.is_valid.at(c) = false;
+    }
+  }
+}
+
+int PolicyTuner::getFastestCandidate(const BucketTotals &totals) const {
+  int fastest = 0;
+  for (std::size_t c = 1; c < candidates_.size(); ++c) {
+    if (totals.is_valid.at(c) &&
+        totals.time_nanos.at(c) < totals.time_nanos.at(fastest)) {
+      fastest = c;
+    }
+  }
+  return fastest;
+}
+
+SelectionPolicy PolicyTuner::getPolicy() const {
+  SelectionPolicy policy;
+  if (!candidates_.empty()) {
+    policy.setDefaultPipeline(candidates_.front());
+  }
+  for (const auto &bucket_and_totals : totals_) {
+    const BucketTotals &totals = bucket_and_totals.second;
+    if (totals.num_samples < core::kPolicyMinSamples) {
+      continue;
+    }
+    const int fastest = getFastestCandidate(totals);
+    if (fastest != 0) {
+      policy.setPipeline(bucket_and_totals.first, candidates_.at(fastest));
+    }
+  }
+  return policy;
+}
+
+void PolicyTuner::writeReport(std::ostream &report_stream) const {
+  for (const auto &bucket_and_totals : totals_) {
+    const BucketTotals &totals = bucket_and_totals.second;
+    report_stream << "Bucket";
+    for (const int value : bucket_and_totals.first) {
+      report_stream << " " << value;
+    }
+    report_stream << ": " << totals.num_samples << " samples" << std::endl;
+    for (std::size_t c = 0; c < candidates_.size(); ++c) {
+      report_stream << "  " << candidates_.at(c) << ": "
+                    << static_cast<double>(totals.time_nanos.at(c)) /
+                           1'000'000'000
+                    << " seconds"
+                    << (totals.is_valid.at(c) ? "" : ", verdicts differ")
+                    << std::endl;
+    }
+  }
+}
+
+} // namespace solvers::pipeline
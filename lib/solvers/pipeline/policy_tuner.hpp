@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+#include "selection_policy.hpp"
+
+namespace solvers::pipeline {
+
+/**
+ * @brief Sums the time each candidate pipeline took on the sampled problems
+ * of every bucket, and builds the policy picking the fastest one. The first
+ * candidate is the reference: a candidate is only picked for a bucket if it
+ * gave the reference's verdict on every sample of it
+ */
+class PolicyTuner {
+public:
+  // pipelines tried when tuning, the default first
+  static const std::vector<std::string> kCandidatePipelines;
+
+  explicit PolicyTuner(const std::vector<std::string> &candidates);
+
+  /**
+   * @brief returns the candidate pipelines, in the order samples give them
+   *
+   * @return const std::vector<std::string>&
+   */
+  const std::vector<std::string> &getCandidates() const;
+
+  /**
+   * @brief record a sampled problem
+   *
+   * @param bucket bucket of the problem
+   * @param times_nanos time each candidate took
+   * @param solve_statuses verdict of each candidate
+   */
+  void addSample(const SelectionPolicy::Bucket &bucket,
+                 const std::vector<std::uint64_t> &times_nanos,
+                 const std::vector<core::SolveStatus> &solve_statuses);
+
+  /**
+   * @brief Policy with the fastest valid candidate of every bucket with at
+   * least kPolicyMinSamples samples. Buckets where that is the reference
+   * are left to the default
+   *
+   * @return SelectionPolicy
+   */
+  SelectionPolicy getPolicy() const;
+
+  /**
+   * @brief write the samples, total time and validity of every candidate
+   * per bucket
+   *
+   * @param report_stream
+   */
+  void writeReport(std::ostream &report_stream) const;
+
+private:
+  struct BucketTotals {
+    int num_samples;
+    std::vector<std::uint64_t> time_nanos;
+    std::vector<bool> is_valid;
+  };
+
+  std::vector<std::string> candidates_;
+  std::map<SelectionPolicy::Bucket, BucketTotals> totals_;
+
+  /**
+   * @brief returns the index of the fastest valid candidate of a bucket
+   *
+   * @param totals
+   * @return int
+   */
+  int getFastestCandidate(const BucketTotals &totals) const;
+};
+
+} // namespace solvers::pipeline
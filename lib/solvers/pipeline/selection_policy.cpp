@@ -0,0 +1,155 @@
+#include "selection_policy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace solvers::pipeline {
+
+namespace {
+
+/**
+ * @brief ceil of log2 of a count, capped at kPolicyMaxSizeBucket
+ *
+ * @param count
+ * @return int
+ */
+int getSizeBucket(const int count) {
+  int bucket = 0;
+  while (bucket < core::kPolicyMaxSizeBucket && (1 << bucket) < count) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+} // namespace
+
+SelectionPolicy::SelectionPolicy() : default_pipeline_(kDefaultPipeline) {}
+
+core::ProblemFeatures
+SelectionPolicy::getFeatures(const core::InputRows &problem) {
+  core::ProblemFeatures features;
+  // the reader counts the constant term as a variable
+  features.num_columns = problem.num_variables - 1;
+  features.num_rows = static_cast<int>(problem.inequality_rows.size() +
+                                       problem.equality_rows.size());
+  features.equality_share =
+      features.num_rows > 0
+          ? static_cast<double>(problem.equality_rows.size()) /
+                features.num_rows
+          : 0;
+
+  int num_nonzeros = 0;
+  float min_coefficient = std::numeric_limits<float>::max();
+  float max_coefficient = 0;
+  for (const auto *rows : {&problem.inequality_rows, &problem.equality_rows}) {
+    for (const std::vector<float> &row : *rows) {
+      for (std::size_t j = 1; j < row.size(); ++j) {
+        const float value = std::fabs(row[j]);
+        if (value != 0) {
+          ++num_nonzeros;
+          min_coefficient = std::min(min_coefficient, value);
+          max_coefficient = std::max(max_coefficient, value);
+        }
+      }
+    }
+  }
+  const int num_entries = features.num_rows * features.num_columns;
+  features.density =
+      num_entries > 0 ? static_cast<double>(num_nonzeros) / num_entries : 0;
+  features.coefficient_range =
+      num_nonzeros > 0 ? max_coefficient / min_coefficient : 1;
+  return features;
+}
+
+SelectionPolicy::Bucket
+SelectionPolicy::getBucket(const core::ProblemFeatures &features) {
+  const int equality_bucket = features.equality_share == 0     ? 0
+                              : features.equality_share < 0.5 ? 1
+                                                               : 2;
+  const int density_bucket =
+      std::min(static_cast<int>(features.density * core::kPolicyDensityBuckets),
+               core::kPolicyDensityBuckets - 1);
+  const int range_bucket =
+      std::min(static_cast<int>(std::log10(features.coefficient_range)),
+               core::kPolicyMaxRangeBucket);
+  return {getSizeBucket(features.num_columns),
+          getSizeBucket(features.num_rows), equality_bucket, density_bucket,
+          range_bucket};
+}
+
+const std::string &
+SelectionPolicy::getPipeline(const core::ProblemFeatures &features) const {
+  const auto it = pipelines_.find(getBucket(features));
+  return it != pipelines_.end() ? it->second : default_pipeline_;
+}
+
+void SelectionPolicy::setPipeline(const Bucket &bucket,
+                                  const std::string &pipeline) {
+  pipelines_[bucket] = pipeline;
+}
+
+void SelectionPolicy::setDefaultPipeline(const std::string &pipeline) {
+  default_pipeline_ = pipeline;
+}
+
+std::vector<std::string> SelectionPolicy::getPipelines() const {
+  std::vector<std::string> pipelines = {default_pipeline_};
+  for (const auto &bucket_and_pipeline : pipelines_) {
+    if (std::find(pipelines.begin(), pipelines.end(),
+                  bucket_and_pipeline.second) == pipelines.end()) {
+      pipelines.push_back(bucket_and_pipeline.second);
+    }
+  }
+  return pipelines;
+}
+
+bool SelectionPolicy::readTable(std::istream &table_stream) {
+  std::string default_pipeline = kDefaultPipeline;
+  std::map<Bucket, std::string> pipelines;
+  std::string line;
+  while (std::getline(table_stream, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    std::istringstream line_stream(line);
+    std::string first;
+    std::string pipeline;
+    line_stream >> first;
+    if (first == "default") {
+      if (!(line_stream >> pipeline)) {
+        return false;
+      }
+      default_pipeline = pipeline;
+      continue;
+    }
+
+    Bucket bucket;
+    line_stream.str(line);
+    line_stream.clear();
+    for (int &value : bucket) {
+      line_stream >> value;
+    }
+    if (!(line_stream >> pipeline)) {
+      return false;
+    }
+    pipelines[bucket] = pipeline;
+  }
+  default_pipeline_ = default_pipeline;
+  pipelines_.swap(pipelines);
+  return true;
+}
+
+void SelectionPolicy::writeTable(std::ostream &table_stream) const {
+  table_stream << "# columns rows equalities density range pipeline"
+               << std::endl;
+  table_stream << "default " << default_pipeline_ << std::endl;
+  for (const auto &bucket_and_pipeline : pipelines_) {
+    for (const int value : bucket_and_pipeline.first) {
+      table_stream << value << " ";
+    }
+    table_stream << bucket_and_pipeline.second << std::endl;
+  }
+}
+
+} // namespace solvers::pipeline
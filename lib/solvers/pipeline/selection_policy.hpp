@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+
+namespace solvers::pipeline {
+
+/**
+ * @brief Decision table from buckets of problem features to the pipeline
+ * that solves problems of the bucket fastest. A bucket is the log2 of the
+ * columns and of the rows, whether there are no, few or mostly equalities,
+ * the density and the log10 of the coefficient range, each capped. Buckets
+ * missing from the table take the default pipeline
+ */
+class SelectionPolicy {
+public:
+  using Bucket = std::array<int, 5>;
+
+  // the chain CombinedRun runs without optional solvers
+  static constexpr char kDefaultPipeline[] = "presolve,tiny,dual,primal";
+
+  SelectionPolicy();
+
+  /**
+   * @brief features of a problem, read in one pass over its rows
+   *
+   * @param problem
+   * @return core::ProblemFeatures
+   */
+  static core::ProblemFeatures getFeatures(const core::InputRows &problem);
+
+  /**
+   * @brief returns the bucket of the features
+   *
+   * @param features
+   * @return Bucket
+   */
+  static Bucket getBucket(const core::ProblemFeatures &features);
+
+  /**
+   * @brief returns the pipeline for a problem with the given features
+   *
+   * @param features
+   * @return const std::string&
+   */
+  const std::string &getPipeline(const core::ProblemFeatures &features) const;
+
+  /**
+   * @brief set the pipeline of a bucket
+   *
+   * @param bucket
+   * @param pipeline
+   */
+  void setPipeline(const Bucket &bucket, const std::string &pipeline);
+
+  /**
+   * @brief set the pipeline of buckets missing from the table
+   *
+   * @param pipeline
+   */
+  void setDefaultPipeline(const std::string &pipeline);
+
+  /**
+   * @brief returns every pipeline the policy can pick, the default first
+   *
+   * @return std::vector<std::string>
+   */
+  std::vector<std::string> getPipelines() const;
+
+  /**
+   * @brief Replace the table by one written by writeTable(). Returns false,
+   * leaving the table as it was, if a line cannot be read
+   *
+   * @param table_stream
+   * @return bool
+   */
+  bool readTable(std::istream &table_stream);
+
+  /**
+   * @brief write the table, one bucket per line
+   *
+   * @param table_stream
+   */
+  void writeTable(std::ostream &table_stream) const;
+
+private:
+  std::string default_pipeline_;
+  std::map<Bucket, std::string> pipelines_;
+};
+
+} // namespace solvers::pipeline
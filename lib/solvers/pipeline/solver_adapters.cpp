@@ -0,0 +1,206 @@
+#include "solver_adapters.hpp"
+
+namespace solvers::pipeline {
+
+namespace {
+
+/**
+ * @brief sets the bounded problem to the bounded form of the rows, unless a
+ * stage already did or presolve replaced it
+ *
+ * @param problem
+ * @param rf
+ */
+void setBoundedProblem(core::PipelineProblem &problem,
+                       utils::FusedReformatter &rf) {
+  if (problem.is_bounded_set) {
+    return;
+  }
+  rf.reformatProblem(problem.rows);
+  problem.bounded_problem = rf.getBoundedProblem();
+  problem.is_bounded_set = true;
+}
+
+/**
+ * @brief keeps the solution of the bounded problem, which is also one of the
+ * rows unless presolve reduced it
+ *
+ * @param problem
+ * @param solution
+ */
+void setBoundedSolution(core::PipelineProblem &problem,
+                        const std::vector<double> &solution) {
+  problem.solution = solution;
+  if (!problem.is_reduced) {
+    problem.variable_values = solution;
+  }
+}
+
+} // namespace
+
+PresolveAdapter::PresolveAdapter() : is_reduced_(false) {}
+
+core::SolveStatus
+PresolveAdapter::solveProblem(core::PipelineProblem &problem) {
+  rf_.reformatProblem(problem.rows);
+  const core::FormattedLogicalProblem &logical_problem =
+      rf_.getLogicalProblem();
+  presolve_.emplace(logical_problem.problem_matrix,
+                    logical_problem.lower_bounds,
+                    logical_problem.upper_bounds,
+                    static_cast<int>(problem.rows.inequality_rows.size()),
+                    static_cast<int>(problem.rows.equality_rows.size()), false);
+
+  presolve_->applyPresolve();
+  if (presolve_->reduced_to_empty_) {
+    presolve_->applyPostsolve();
+  }
+  problem.is_presolved = true;
+  if (presolve_->infeasible_ || (presolve_->reduced_to_empty_ &&
+                                 !presolve_->unsatisfied_constraints_)) {
+    problem.presolve_stats = presolve_->getStats();
+    if (presolve_->infeasible_) {
+      return core::SolveStatus::kInfeasible;
+    }
+    problem.variable_values = presolve_->getFeasibleSolution();
+    return core::SolveStatus::kFeasible;
+  }
+
+  // the later stages solve what presolve left, or the full problem if it
+  // could not reduce it
+  is_reduced_ = !presolve_->reduced_to_empty_ && !presolve_->overflow_;
+  if (is_reduced_) {
+    problem.bounded_problem = presolve_->getReducedProblem().problem;
+    problem.is_bounded_set = true;
+    problem.is_reduced = true;
+  }
+  return core::SolveStatus::kDidntConverge;
+}
+
+void PresolveAdapter::finishProblem(const core::SolveStatus solve_status,
+                                    core::PipelineProblem &problem) {
+  // recover the solution of the full problem from the reduced one. Stages
+  // solving the rows leave no solution of it
+  if (is_reduced_) {
+    const bool is_solution_set =
+        solve_status == core::SolveStatus::kFeasible &&
+        !problem.solution.empty();
+    if (is_solution_set) {
+      presolve_->setReducedSolution(problem.solution);
+    }
+    presolve_->applyPostsolve();
+    if (is_solution_set && !presolve_->unsatisfied_constraints_) {
+      problem.variable_values = presolve_->getFeasibleSolution();
+    }
+  }
+  problem.presolve_stats = presolve_->getStats();
+}
+
+core::SolveStatus
+FourierMotzkinAdapter::solveProblem(core::PipelineProblem &problem) {
+  setBoundedProblem(problem, rf_);
+  if (problem.bounded_problem.column_lower_bounds.size() >
+      core::kFourierMotzkinMaxColumns) {
+    return core::SolveStatus::kDidntConverge;
+  }
+  solver_.setProblem(problem.bounded_problem);
+  const core::SolveStatus solve_status = solver_.solveProblem();
+  if (solve_status == core::SolveStatus::kFeasible) {
+    setBoundedSolution(problem, solver_.getSolution());
+  }
+  return solve_status;
+}
+
+TinyDualAdapter::TinyDualAdapter(const SolverOptions &options) {
+  solver_.setPerturbation(options.is_perturbation_enabled);
+}
+
+core::SolveStatus TinyDualAdapter::solveProblem(core::PipelineProblem &problem) {
+  setBoundedProblem(problem, rf_);
+  if (!solver_.isSupported(problem.bounded_problem)) {
+    return core::SolveStatus::kDidntConverge;
+  }
+  const core::SolveStatus solve_status =
+      solver_.solveProblem(problem.bounded_problem);
+  problem.simplex_stats.push_back(solver_.getStats());
+  if (solve_status == core::SolveStatus::kFeasible) {
+    setBoundedSolution(problem, solver_.getSolution());
+  }
+  return solve_status;
+}
+
+BoundedDualAdapter::BoundedDualAdapter(const SolverOptions &options) {
+  solver_.setPerturbation(options.is_perturbation_enabled);
+}
+
+core::SolveStatus
+BoundedDualAdapter::solveProblem(core::PipelineProblem &problem) {
+  setBoundedProblem(problem, rf_);
+  solver_.setProblem(problem.bounded_problem);
+  const core::SolveStatus solve_status = solver_.solveProblem();
+  problem.simplex_stats.push_back(solver_.getStats());
+  if (solve_status == core::SolveStatus::kFeasible) {
+    setBoundedSolution(problem, solver_.getSolution());
+  }
+  return solve_status;
+}
+
+BlandPrimalAdapter::BlandPrimalAdapter(const SolverOptions &options)
+    : is_perturbation_enabled_(options.is_perturbation_enabled) {
+  solver_.setPricingStrategy(options.pricing_strategy);
+  solver_.setPerturbation(options.is_perturbation_enabled);
+}
+
+core::SolveStatus
+BlandPrimalAdapter::solveProblem(core::PipelineProblem &problem) {
+  rf_.reformatPrimalProblem(problem.rows);
+  const core::FormattedPrimalProblem &rf_prob = rf_.getPrimalProblem();
+  solver_.setProblem(rf_prob.problem_matrix);
+  solver_.setBasis(rf_prob.basic_variables);
+  core::SolveStatus solve_status = solver_.solveProblem(false, problem.rows);
+  problem.simplex_stats.push_back(solver_.getStats());
+
+  // stalling on the degenerate table, retry with perturbed bounds
+  if (solve_status == core::SolveStatus::kDidntConverge &&
+      !is_perturbation_enabled_) {
+    solver_.setProblem(rf_prob.problem_matrix);
+    solver_.setBasis(rf_prob.basic_variables);
+    solver_.setPerturbation(true);
+    solve_status = solver_.solveProblem(false, problem.rows);
+    solver_.setPerturbation(false);
+    problem.simplex_stats.push_back(solver_.getStats());
+  }
+  if (solve_status == core::SolveStatus::kFeasible) {
+    problem.variable_values = solver_.getSolution();
+  }
+  return solve_status;
+}
+
+core::SolveStatus
+InteriorPointAdapter::solveProblem(core::PipelineProblem &problem) {
+  if (problem.rows.num_variables - 1 < core::kInteriorPointMinVariables) {
+    return core::SolveStatus::kDidntConverge;
+  }
+  solver_.setProblem(problem.rows);
+  const core::SolveStatus solve_status = solver_.solveProblem();
+  problem.interior_point_iterations.push_back(solver_.getIterationCount());
+  if (solve_status == core::SolveStatus::kFeasible) {
+    problem.variable_values = solver_.getSolution();
+  }
+  return solve_status;
+}
+
+core::SolveStatus PdhgAdapter::solveProblem(core::PipelineProblem &problem) {
+  if (problem.rows.num_variables - 1 < core::kPdhgMinVariables) {
+    return core::SolveStatus::kDidntConverge;
+  }
+  solver_.setProblem(problem.rows);
+  const core::SolveStatus solve_status = solver_.solveProblem();
+  problem.pdhg_iterations.push_back(solver_.getIterationCount());
+  if (solve_status == core::SolveStatus::kFeasible) {
+    problem.variable_values = solver_.getSolution();
+  }
+  return solve_status;
+}
+
+} // namespace solvers::pipeline
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "../../core/consts.hpp"
+#include "../../core/types.hpp"
+#include "../../utils/fused_reformatter.hpp"
+#include "../bounded_dual/bounded_dual_simplex.hpp"
+#include "../bounded_dual/tiny_dual_simplex_dispatcher.hpp"
+#include "../fourier_motzkin/fourier_motzkin.hpp"
+#include "../interior_point/interior_point.hpp"
+#include "../logical_solver/presolve.hpp"
+#include "../pdhg/pdhg.hpp"
+#include "../primal_bland/bland_simplex.hpp"
+
+namespace solvers::pipeline {
+
+/**
+ * @brief settings shared by every stage of a pipeline
+ */
+struct SolverOptions {
+  core::PricingStrategy pricing_strategy;
+  bool is_perturbation_enabled;
+};
+
+/**
+ * @brief Presolve as a stage. Gives a verdict when presolve does, otherwise
+ * passes on its reduced problem as the bounded problem, and postsolves the
+ * solution the later stages found once they are done
+ */
+class PresolveAdapter : public core::ISolver {
+public:
+  PresolveAdapter();
+
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+  void finishProblem(const core::SolveStatus solve_status,
+                     core::PipelineProblem &problem) override;
+
+private:
+  utils::FusedReformatter rf_;
+  // presolve of the problem being solved, kept until it is postsolved
+  std::optional<logical_solver::Presolve> presolve_;
+  bool is_reduced_;
+};
+
+/**
+ * @brief Fourier-Motzkin elimination on bounded problems of at most
+ * kFourierMotzkinMaxColumns columns, larger ones are passed on
+ */
+class FourierMotzkinAdapter : public core::ISolver {
+public:
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+private:
+  utils::FusedReformatter rf_;
+  fourier_motzkin::FourierMotzkin solver_;
+};
+
+/**
+ * @brief the fixed size dual simplex on the bounded problems it supports,
+ * others are passed on
+ */
+class TinyDualAdapter : public core::ISolver {
+public:
+  explicit TinyDualAdapter(const SolverOptions &options);
+
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+private:
+  utils::FusedReformatter rf_;
+  bounded_dual::TinyDualSimplexDispatcher solver_;
+};
+
+/**
+ * @brief the bounded dual simplex on the bounded problem
+ */
+class BoundedDualAdapter : public core::ISolver {
+public:
+  explicit BoundedDualAdapter(const SolverOptions &options);
+
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+private:
+  utils::FusedReformatter rf_;
+  bounded_dual::BoundedDualSimplex solver_;
+};
+
+/**
+ * @brief the primal simplex on the table of the rows. Without perturbation a
+ * solve that does not converge is retried once with it
+ */
+class BlandPrimalAdapter : public core::ISolver {
+public:
+  explicit BlandPrimalAdapter(const SolverOptions &options);
+
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+private:
+  utils::FusedReformatter rf_;
+  bland_simplex::BlandPrimalSimplex solver_;
+  bool is_perturbation_enabled_;
+};
+
+/**
+ * @brief the interior point method on rows of at least
+ * kInteriorPointMinVariables variables, smaller ones are passed on
+ */
+class InteriorPointAdapter : public core::ISolver {
+public:
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+private:
+  interior_point::InteriorPoint solver_;
+};
+
+/**
+ * @brief PDHG on rows of at least kPdhgMinVariables variables, smaller ones
+ * are passed on
+ */
+class PdhgAdapter : public core::ISolver {
+public:
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+private:
+  pdhg::PrimalDualHybridGradient solver_;
+};
+
+} // namespace solvers::pipeline
@@ -0,0 +1,51 @@
+#include "solver_pipeline.hpp"
+
+#include <algorithm>
+
+namespace solvers::pipeline {
+
+void SolverPipeline::addStage(const std::string &name,
+                              std::unique_ptr<core::ISolver> stage) {
+  stage_names_.push_back(name);
+  stages_.push_back(std::move(stage));
+}
+
+const std::vector<std::string> &SolverPipeline::getStageNames() const {
+  return stage_names_;
+}
+
+const std::string &SolverPipeline::getVerdictStageName() const {
+  return stage_names_.at(verdict_stage_);
+}
+
+core::SolveStatus
+SolverPipeline::solveProblem(core::PipelineProblem &problem) {
+  core::SolveStatus solve_status = core::SolveStatus::kDidntConverge;
+  std::size_t num_passed = 0;
+  for (; num_passed < stages_.size(); ++num_passed) {
+    problem.solution.clear();
+    problem.variable_values.clear();
+    solve_status = stages_[num_passed]->solveProblem(problem);
+    if (solve_status == core::SolveStatus::kFeasible ||
+        solve_status == core::SolveStatus::kInfeasible) {
+      break;
+    }
+  }
+  verdict_stage_ = std::min(num_passed, stages_.size() - 1);
+
+  // the stage giving the verdict is not told about it, the ones that passed
+  // the problem on are
+  for (std::size_t s = num_passed; s-- > 0;) {
+    stages_[s]->finishProblem(solve_status, problem);
+  }
+  return solve_status;
+}
+
+void SolverPipeline::finishProblem(const core::SolveStatus solve_status,
+                                   core::PipelineProblem &problem) {
+  for (std::size_t s = stages_.size(); s-- > 0;) {
+    stages_[s]->finishProblem(solve_status, problem);
+  }
+}
+
+} // namespace solvers::pipeline
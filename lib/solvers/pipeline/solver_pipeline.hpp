@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../core/types.hpp"
+
+namespace solvers::pipeline {
+
+/**
+ * @brief Stages tried in order until one gives a verdict. The stages before
+ * it then hear the verdict in reverse order, so presolve postsolves after
+ * the stages that solved its reduced problem. Being a solver itself, a
+ * pipeline can be a stage of another
+ */
+class SolverPipeline : public core::ISolver {
+public:
+  /**
+   * @brief append a stage
+   *
+   * @param name name it was built from, for reports
+   * @param stage
+   */
+  void addStage(const std::string &name, std::unique_ptr<core::ISolver> stage);
+
+  /**
+   * @brief returns the names of the stages, in order
+   *
+   * @return const std::vector<std::string>&
+   */
+  const std::vector<std::string> &getStageNames() const;
+
+  /**
+   * @brief returns the name of the stage that gave the verdict on the last
+   * problem, or of the last one tried if none did
+   *
+   * @return const std::string&
+   */
+  const std::string &getVerdictStageName() const;
+
+  /**
+   * @brief Try the stages in order. Returns the first verdict, or the status
+   * of the last stage if none gave one
+   *
+   * @param problem
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem(core::PipelineProblem &problem) override;
+
+  void finishProblem(const core::SolveStatus solve_status,
+                     core::PipelineProblem &problem) override;
+
+private:
+  std::vector<std::string> stage_names_;
+  std::vector<std::unique_ptr<core::ISolver>> stages_;
+  std::size_t verdict_stage_ = 0;
+};
+
+} // namespace solvers::pipeline
@@ -0,0 +1,86 @@
+#include "solver_registry.hpp"
+
+namespace solvers::pipeline {
+
+SolverRegistry::SolverRegistry() {
+  registerSolver("presolve", [](const SolverOptions &) {
+    return std::make_unique<PresolveAdapter>();
+  });
+  registerSolver("fourier_motzkin", [](const SolverOptions &) {
+    return std::make_unique<FourierMotzkinAdapter>();
+  });
+  registerSolver("tiny", [](const SolverOptions &options) {
+    return std::make_unique<TinyDualAdapter>(options);
+  });
+  registerSolver("dual", [](const SolverOptions &options) {
+    return std::make_unique<BoundedDualAdapter>(options);
+  });
+  registerSolver("primal", [](const SolverOptions &options) {
+    return std::make_unique<BlandPrimalAdapter>(options);
+  });
+  registerSolver("interior_point", [](const SolverOptions &) {
+    return std::make_unique<InteriorPointAdapter>();
+  });
+  registerSolver("pdhg", [](const SolverOptions &) {
+    return std::make_unique<PdhgAdapter>();
+  });
+}
+
+void SolverRegistry::registerSolver(const std::string &name,
+                                    Factory factory) {
+  factories_[name] = std::move(factory);
+}
+
+std::vector<std::string> SolverRegistry::getNames() const {
+  std::vector<std::string> names;
+  for (const auto &name_and_factory : factories_) {
+    names.push_back(name_and_factory.first);
+  }
+  return names;
+}
+
+bool SolverRegistry::isValidPipeline(const std::string &pipeline) const {
+  const std::vector<std::string> names = splitNames(pipeline);
+  if (names.empty()) {
+    return false;
+  }
+  for (const std::string &name : names) {
+    if (factories_.count(name) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<SolverPipeline>
+SolverRegistry::createPipeline(const std::string &pipeline,
+                               const SolverOptions &options) const {
+  if (!isValidPipeline(pipeline)) {
+    return std::nullopt;
+  }
+  SolverPipeline solver_pipeline;
+  for (const std::string &name : splitNames(pipeline)) {
+    solver_pipeline.addStage(name, factories_.at(name)(options));
+  }
+  return solver_pipeline;
+}
+
+std::vector<std::string>
+SolverRegistry::splitNames(const std::string &pipeline) {
+  std::vector<std::string> names;
+  std::size_t start = 0;
+  while (start <= pipeline.size()) {
+    std::size_t end = pipeline.find(',', start);
+    if (end == std::string::npos) {
+      end = pipeline.size();
+    }
+    names.push_back(pipeline.substr(start, end - start));
+    start = end + 1;
+  }
+  if (pipeline.empty()) {
+    names.clear();
+  }
+  return names;
+}
+
+} // namespace solvers::pipeline
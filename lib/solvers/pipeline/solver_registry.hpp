@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../../core/types.hpp"
+#include "solver_adapters.hpp"
+#include "solver_pipeline.hpp"
+
+namespace solvers::pipeline {
+
+/**
+ * @brief Builds solvers by name, and pipelines from a comma separated list
+ * of names such as "presolve,tiny,dual,primal". These solvers are registered
+ * on construction: presolve, fourier_motzkin, tiny, dual, primal,
+ * interior_point and pdhg. The tableau dual simplex of dual_simplex is left
+ * out, its verdicts on the sample problems are not reliable
+ */
+class SolverRegistry {
+public:
+  using Factory =
+      std::function<std::unique_ptr<core::ISolver>(const SolverOptions &)>;
+
+  SolverRegistry();
+
+  /**
+   * @brief register a solver, replacing any of the same name
+   *
+   * @param name
+   * @param factory builds a new instance with the given options
+   */
+  void registerSolver(const std::string &name, Factory factory);
+
+  /**
+   * @brief returns the registered names in alphabetical order
+   *
+   * @return std::vector<std::string>
+   */
+  std::vector<std::string> getNames() const;
+
+  /**
+   * @brief returns whether every name of the list is registered
+   *
+   * @param pipeline comma separated names
+   * @return bool
+   */
+  bool isValidPipeline(const std::string &pipeline) const;
+
+  /**
+   * @brief Build a pipeline with a new instance of each named solver.
+   * Returns nothing if the list is empty or a name is not registered
+   *
+   * @param pipeline comma separated names
+   * @param options
+   * @return std::optional<SolverPipeline>
+   */
+  std::optional<SolverPipeline>
+  createPipeline(const std::string &pipeline,
+                 const SolverOptions &options) const;
+
+private:
+  std::map<std::string, Factory> factories_;
+
+  /**
+   * @brief splits a list at its commas
+   *
+   * @param pipeline
+   * @return std::vector<std::string>
+   */
+  static std::vector<std::string> splitNames(const std::string &pipeline);
+};
+
+} // namespace solvers::pipeline
@@ -4,10 +4,34 @@
 #include <core/consts.hpp>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <random>
 
 namespace solvers::bland_simplex {
 
-BlandPrimalSimplex::BlandPrimalSimplex() {}
+BlandPrimalSimplex::BlandPrimalSimplex()
+    : pricing_strategy_(core::PricingStrategy::kBland),
+      active_pricing_strategy_(core::PricingStrategy::kBland),
+      partial_pricing_start_(1), basis_hash_(0),
+      is_perturbation_enabled_(false), stats_() {}
+
+void BlandPrimalSimplex::setPerturbation(const bool is_perturbation_enabled) {
+  is_perturbation_enabled_ = is_perturbation_enabled;
+}
+
+core::SimplexStats BlandPrimalSimplex::getStats() { return stats_; }
+
+std::vector<double> BlandPrimalSimplex::getSolution() {
+  if (solution_.empty()) {
+    return {};
+  }
+  return std::vector<double>(solution_.begin() + 1, solution_.end());
+}
+
+void BlandPrimalSimplex::setPricingStrategy(
+    const core::PricingStrategy pricing_strategy) {
+  pricing_strategy_ = pricing_strategy;
+}
 
 void BlandPrimalSimplex::setProblem(
     const std::vector<std::vector<float>> table) {
@@ -28,6 +52,18 @@ void BlandPrimalSimplex::setBasis(const std::vector<int> basis) {
   for (size_t i = 0; i < basis.size(); ++i) {
     basis_.push_back(basis.at(i));
   }
+
+  // flag basic columns and hash the basis
+  is_basic_.assign(table_.at(0).size(), false);
+  basis_hash_ = 0;
+  for (size_t i = 0; i < basis_.size(); ++i) {
+    is_basic_.at(basis_.at(i)) = true;
+    basis_hash_ += utils::hashBasisColumn(basis_.at(i));
+  }
+}
+
+bool BlandPrimalSimplex::isBasisRepeated() {
+  return !visited_basis_hashes_.insert(basis_hash_).second;
 }
 
 std::vector<float>
@@ -42,13 +78,30 @@ BlandPrimalSimplex::extractColumnFromTable(const int column_index) {
 }
 
 int BlandPrimalSimplex::getPivotColumnIndex() {
+  switch (active_pricing_strategy_) {
+  case core::PricingStrategy::kDantzig:
+    return getDantzigPivotColumnIndex(1, table_.at(0).size() - 1);
+
+  case core::PricingStrategy::kPartial:
+    return getPartialPivotColumnIndex();
+
+  case core::PricingStrategy::kDevex:
+  case core::PricingStrategy::kSteepestEdge:
+    return getWeightedPivotColumnIndex();
+
+  default:
+    return getBlandPivotColumnIndex();
+  }
+}
+
+int BlandPrimalSimplex::getBlandPivotColumnIndex() {
 
   // get objective function
-  const std::vector<float> objective_function = table_.at(0);
+  const std::vector<float> &objective_function = table_.at(0);
 
   for (std::size_t i = 1; i < objective_function.size(); ++i) {
-    if (objective_function.at(i) < 0 &&
-        std::find(basis_.begin(), basis_.end(), i) == basis_.end()) {
+    if (objective_function.at(i) < -core::kFloatOptimalityTolerance &&
+        !is_basic_.at(i)) {
       return i;
     }
   }
@@ -56,20 +109,173 @@ int BlandPrimalSimplex::getPivotColumnIndex() {
   return -1;
 }
 
-int BlandPrimalSimplex::getPivotRowIndex(const int pivot_column_index) {
+int BlandPrimalSimplex::getDantzigPivotColumnIndex(const std::size_t start,
+                                                   const std::size_t end) {
 
-  // extract pivot column
-  const std::vector<float> pivot_column =
-      extractColumnFromTable(pivot_column_index);
+  const std::vector<float> &objective_function = table_.at(0);
 
-  for (std::size_t i = 1; i < pivot_column.size(); ++i) {
-    if (pivot_column.at(i) > 0) {
-      return i;
+  int pivot_column_index = -1;
+  float most_negative = -core::kFloatOptimalityTolerance;
+  for (std::size_t i = start; i < end; ++i) {
+    if (objective_function.at(i) < most_negative && !is_basic_.at(i)) {
+      most_negative = objective_function.at(i);
+      pivot_column_index = i;
+    }
+  }
+  return pivot_column_index;
+}
+
+int BlandPrimalSimplex::getPartialPivotColumnIndex() {
+
+  // columns 1 to the bounds column are split into blocks
+  const std::size_t num_columns = table_.at(0).size() - 2;
+  const std::size_t block_size =
+      std::max<std::size_t>(1, num_columns / kPartialPricingBlocks);
+
+  if (partial_pricing_start_ < 1 || partial_pricing_start_ > num_columns) {
+    partial_pricing_start_ = 1;
+  }
+
+  // search blocks in turn, wrapping around, until one has a candidate
+  std::size_t start = partial_pricing_start_;
+  for (std::size_t searched = 0; searched < num_columns;) {
+    const std::size_t end = std::min(start + block_size, num_columns + 1);
+    const int pivot_column_index = getDantzigPivotColumnIndex(start, end);
+    searched += end - start;
+    start = end > num_columns ? 1 : end;
+    if (pivot_column_index != -1) {
+      partial_pricing_start_ = start;
+      return pivot_column_index;
     }
   }
   return -1;
 }
 
+int BlandPrimalSimplex::getWeightedPivotColumnIndex() {
+
+  const std::vector<float> &objective_function = table_.at(0);
+  const bool is_steepest_edge =
+      active_pricing_strategy_ == core::PricingStrategy::kSteepestEdge;
+
+  int pivot_column_index = -1;
+  float best_score = 0;
+  for (std::size_t j = 1; j < objective_function.size() - 1; ++j) {
+    const float reduced_cost = objective_function.at(j);
+    if (reduced_cost >= -core::kFloatOptimalityTolerance || is_basic_.at(j)) {
+      continue;
+    }
+
+    float weight;
+    if (is_steepest_edge) {
+      // exact edge norm read from the dense table
+      weight = 1;
+      for (std::size_t i = 1; i < table_.size(); ++i) {
+        weight += table_.at(i).at(j) * table_.at(i).at(j);
+      }
+    } else {
+      weight = devex_weights_.at(j);
+    }
+
+    const float score = reduced_cost * reduced_cost / weight;
+    if (score > best_score) {
+      best_score = score;
+      pivot_column_index = j;
+    }
+  }
+  return pivot_column_index;
+}
+
+void BlandPrimalSimplex::updateDevexWeights(const int pivot_row_index,
+                                            const int pivot_column_index) {
+
+  const std::vector<float> &pivot_row = table_.at(pivot_row_index);
+  const float pivot_value = pivot_row.at(pivot_column_index);
+  const float pivot_weight = devex_weights_.at(pivot_column_index);
+
+  for (std::size_t j = 1; j < pivot_row.size() - 1; ++j) {
+    if (is_basic_.at(j) || j == pivot_column_index) {
+      continue;
+    }
+    const float ratio = pivot_row.at(j) / pivot_value;
+    devex_weights_.at(j) =
+        std::max(devex_weights_.at(j), ratio * ratio * pivot_weight);
+  }
+
+  // weight of the leaving column
+  const int leaving_column_index = basis_.at(pivot_row_index - 1);
+  devex_weights_.at(leaving_column_index) =
+      std::max(pivot_weight / (pivot_value * pivot_value), 1.0F);
+}
+
+int BlandPrimalSimplex::getPivotRowIndex(const int pivot_column_index) {
+  if (active_pricing_strategy_ == core::PricingStrategy::kBland) {
+    return getBlandPivotRowIndex(pivot_column_index);
+  }
+  return getHarrisPivotRowIndex(pivot_column_index);
+}
+
+int BlandPrimalSimplex::getBlandPivotRowIndex(const int pivot_column_index) {
+
+  const std::size_t bounds_column_index = table_.at(0).size() - 1;
+
+  int pivot_row_index = -1;
+  float min_ratio = 0;
+  for (std::size_t i = 1; i < table_.size(); ++i) {
+    const float pivot_column_entry = table_.at(i).at(pivot_column_index);
+    if (pivot_column_entry < core::kFloatPivotTolerance) {
+      continue;
+    }
+    const float ratio =
+        std::max(table_.at(i).at(bounds_column_index), 0.0F) /
+        pivot_column_entry;
+
+    // on ties keep the row whose basic column has the smallest index
+    if (pivot_row_index == -1 || ratio < min_ratio ||
+        (ratio == min_ratio && i <= basis_.size() &&
+         pivot_row_index <= basis_.size() &&
+         basis_.at(i - 1) < basis_.at(pivot_row_index - 1))) {
+      min_ratio = ratio;
+      pivot_row_index = i;
+    }
+  }
+  return pivot_row_index;
+}
+
+int BlandPrimalSimplex::getHarrisPivotRowIndex(const int pivot_column_index) {
+
+  const std::size_t bounds_column_index = table_.at(0).size() - 1;
+
+  // pass one: largest step keeping every row within tolerance
+  float max_step = std::numeric_limits<float>::max();
+  for (std::size_t i = 1; i < table_.size(); ++i) {
+    const float pivot_column_entry = table_.at(i).at(pivot_column_index);
+    if (pivot_column_entry < core::kFloatPivotTolerance) {
+      continue;
+    }
+    const float relaxed_ratio = (table_.at(i).at(bounds_column_index) +
+                                 core::kFloatFeasibilityTolerance) /
+                                pivot_column_entry;
+    max_step = std::min(max_step, relaxed_ratio);
+  }
+
+  // pass two: largest pivot among rows whose ratio is within the step
+  int pivot_row_index = -1;
+  float max_pivot = 0;
+  for (std::size_t i = 1; i < table_.size(); ++i) {
+    const float pivot_column_entry = table_.at(i).at(pivot_column_index);
+    if (pivot_column_entry < core::kFloatPivotTolerance) {
+      continue;
+    }
+    const float ratio =
+        table_.at(i).at(bounds_column_index) / pivot_column_entry;
+    if (ratio <= max_step && pivot_column_entry > max_pivot) {
+      max_pivot = pivot_column_entry;
+      pivot_row_index = i;
+    }
+  }
+  return pivot_row_index;
+}
+
 bool BlandPrimalSimplex::switchBasis(const int pivot_row_index,
                                      const int pivot_column_index) {
 
@@ -78,7 +284,12 @@ bool BlandPrimalSimplex::switchBasis(const int pivot_row_index,
     return false;
   }
   // update basis
+  const int leaving_column_index = basis_.at(pivot_row_index - 1);
   basis_.at(pivot_row_index - 1) = pivot_column_index;
+  is_basic_.at(leaving_column_index) = false;
+  is_basic_.at(pivot_column_index) = true;
+  basis_hash_ += utils::hashBasisColumn(pivot_column_index) -
+                 utils::hashBasisColumn(leaving_column_index);
   return true;
 }
 
@@ -91,7 +302,7 @@ void BlandPrimalSimplex::constructNewTable(const int pivot_row_index,
   std::vector<float> new_row;
   std::vector<float> old_row;
   float new_elem;
-  float product;
+  float multiplier;
 
   // defining pivot vectors
   const float pivot_value = table_.at(pivot_row_index).at(pivot_column_index);
@@ -131,12 +342,12 @@ void BlandPrimalSimplex::constructNewTable(const int pivot_row_index,
         old_row.push_back(table_.at(i).at(j));
       }
 
-      // create new row
-      product = pivot_value * pivot_column.at(i);
+      // create new row, eliminating the pivot column entry without
+      // rescaling the row so entries do not grow from pivot to pivot
+      multiplier = pivot_column.at(i) / pivot_value;
 
       for (size_t j = 0; j < old_row.size(); ++j) {
-        new_elem = (old_row.at(j) * (product / pivot_column.at(i))) -
-                   (pivot_row.at(j) * (product / pivot_value));
+        new_elem = old_row.at(j) - (pivot_row.at(j) * multiplier);
         new_row.push_back(new_elem);
       }
       // add new row to new table
@@ -156,7 +367,7 @@ bool BlandPrimalSimplex::checkOptimality() {
   const std::vector<float> objective_row = table_.at(0);
 
   for (size_t i = 0; i < objective_row.size(); ++i) {
-    if (objective_row.at(i) < 0) {
+    if (objective_row.at(i) < -core::kFloatOptimalityTolerance) {
       return false;
     }
   }
@@ -199,6 +410,11 @@ BlandPrimalSimplex::verifySolution(core::InputRows original_problem,
     x.push_back(x_positive.at(i) - x_negative.at(i));
   }
 
+  // a zero objective coefficient leaves no point to recover
+  if (std::fabs(solution_row.at(0)) < core::kFloatPivotTolerance) {
+    return core::SolveStatus::kError;
+  }
+
   if (solution_row.at(0) != 1) {
     for (std::size_t i = 1; i < x.size(); ++i) {
       x.at(i) /= solution_row.at(0);
@@ -207,27 +423,35 @@ BlandPrimalSimplex::verifySolution(core::InputRows original_problem,
 
   solution_ = x;
 
-  // check inequalities hold
+  // check inequalities hold, the tolerance is scaled by the magnitude of the
+  // terms summed so that rounding in large rows is not read as a violation
   float total = 0;
+  float magnitude = 0;
   for (std::size_t i = 0; i < original_problem.inequality_rows.size(); ++i) {
     for (std::size_t j = 0; j < num_primal_variables + 1; ++j) {
-      total += original_problem.inequality_rows.at(i).at(j) * x.at(j);
+      const float term = original_problem.inequality_rows.at(i).at(j) * x.at(j);
+      total += term;
+      magnitude += std::fabs(term);
     }
-    if (total < -core::kEpsilon) {
+    if (!(total >= -core::kFloatFeasibilityTolerance * (1 + magnitude))) {
       return core::SolveStatus::kInfeasible;
     }
     total = 0;
+    magnitude = 0;
   }
 
-  total = 0;
   for (std::size_t i = 0; i < original_problem.equality_rows.size(); ++i) {
     for (std::size_t j = 0; j < num_primal_variables + 1; ++j) {
-      total += original_problem.equality_rows.at(i).at(j) * x.at(j);
+      const float term = original_problem.equality_rows.at(i).at(j) * x.at(j);
+      total += term;
+      magnitude += std::fabs(term);
     }
-    if (std::fabs(total) > core::kEpsilon) {
+    if (!(std::fabs(total) <=
+          core::kFloatFeasibilityTolerance * (1 + magnitude))) {
       return core::SolveStatus::kInfeasible;
     }
     total = 0;
+    magnitude = 0;
   }
 
   return core::SolveStatus::kFeasible;
@@ -241,11 +465,58 @@ void BlandPrimalSimplex::printSolution() {
   std::cout << std::endl;
 }
 
+void BlandPrimalSimplex::perturbBounds() {
+  // fixed seed so that solves are reproducible
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(1, 2);
+
+  const std::size_t bounds_column_index = table_.at(0).size() - 1;
+  for (std::size_t i = 1; i < table_.size(); ++i) {
+    table_.at(i).at(bounds_column_index) =
+        core::kFloatPerturbation * distribution(generator);
+  }
+}
+
+void BlandPrimalSimplex::removeBoundPerturbation() {
+  const std::size_t bounds_column_index = table_.at(0).size() - 1;
+  for (std::size_t i = 0; i < table_.size(); ++i) {
+    table_.at(i).at(bounds_column_index) = 0;
+  }
+}
+
 core::SolveStatus
 BlandPrimalSimplex::solveProblem(const bool run_verbose,
                                  const core::InputRows original_problem) {
 
   solution_.clear();
+
+  // reset pricing state and counters for this problem
+  active_pricing_strategy_ = pricing_strategy_;
+  devex_weights_.assign(table_.at(0).size(), 1);
+  partial_pricing_start_ = 1;
+  visited_basis_hashes_.clear();
+  stats_ = core::SimplexStats();
+
+  if (is_perturbation_enabled_) {
+    perturbBounds();
+    stats_.is_perturbed = true;
+  }
+
+  const core::SolveStatus solve_status =
+      runSimplex(run_verbose, original_problem);
+
+  if (is_perturbation_enabled_) {
+    removeBoundPerturbation();
+  }
+  return solve_status;
+}
+
+core::SolveStatus
+BlandPrimalSimplex::runSimplex(const bool run_verbose,
+                               const core::InputRows &original_problem) {
+
+  const std::size_t bounds_column_index = table_.at(0).size() - 1;
+
   for (size_t i = 0; i < core::kMaxIterations; ++i) {
     int pivot_column_index = getPivotColumnIndex();
     if (pivot_column_index == -1) {
@@ -257,6 +528,15 @@ BlandPrimalSimplex::solveProblem(const bool run_verbose,
     if (pivot_row_index == -1) {
       return core::SolveStatus::kInfeasible;
     }
+    ++stats_.num_iterations;
+    if (table_.at(pivot_row_index).at(bounds_column_index) <
+        core::kFloatFeasibilityTolerance) {
+      ++stats_.num_degenerate_iterations;
+    }
+    if (active_pricing_strategy_ == core::PricingStrategy::kDevex &&
+        pivot_row_index <= basis_.size()) {
+      updateDevexWeights(pivot_row_index, pivot_column_index);
+    }
     bool is_basis_switch_successful =
         switchBasis(pivot_row_index, pivot_column_index);
     if (!is_basis_switch_successful) {
@@ -269,6 +549,18 @@ BlandPrimalSimplex::solveProblem(const bool run_verbose,
           verifySolution(original_problem, table_.at(0));
       return solution_status;
     }
+
+    // a revisited basis means we are cycling, switch to bland's rule
+    if (isBasisRepeated()) {
+      ++stats_.num_repeated_bases;
+      if (active_pricing_strategy_ != core::PricingStrategy::kBland) {
+        active_pricing_strategy_ = core::PricingStrategy::kBland;
+        if (run_verbose) {
+          std::cout << "Cycling detected, falling back to Bland's rule"
+                    << std::endl;
+        }
+      }
+    }
   }
   return core::SolveStatus::kDidntConverge;
 }
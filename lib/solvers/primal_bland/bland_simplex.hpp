@@ -1,9 +1,13 @@
+#pragma once
+
 #include <cstdint>
 #include <optional>
+#include <unordered_set>
 #include <vector>
 
 #include "../../core/consts.hpp"
 #include "../../core/types.hpp"
+#include "../../utils/basis_hash.hpp"
 
 namespace solvers::bland_simplex {
 
@@ -25,6 +29,27 @@ public:
    */
   void setBasis(const std::vector<int> basis);
 
+  /**
+   * @brief Set the pricing strategy used to choose the entering column. Any
+   * strategy other than Bland's rule falls back to Bland's rule for the rest
+   * of a solve once a basis is revisited, since only Bland's rule is
+   * guaranteed not to cycle
+   *
+   * @param pricing_strategy strategy to use for subsequent solves
+   */
+  void setPricingStrategy(const core::PricingStrategy pricing_strategy);
+
+  /**
+   * @brief Enable or disable perturbation of the bounds column. The table is
+   * homogeneous, so every pivot on it is degenerate; small positive bounds
+   * break the ties in the ratio test and are removed again before the
+   * solution is read. Verdicts are unchanged since the perturbed problem is
+   * bounded exactly when the original one is
+   *
+   * @param is_perturbation_enabled
+   */
+  void setPerturbation(const bool is_perturbation_enabled);
+
   /**
    * @brief solve the given problem
    *
@@ -32,9 +57,27 @@ public:
   core::SolveStatus solveProblem(const bool run_verbose,
                                  const core::InputRows original_problem);
 
+  /**
+   * @brief returns the counters of the last solve
+   *
+   * @return core::SimplexStats
+   */
+  core::SimplexStats getStats();
+
+  /**
+   * @brief returns the values of the variables found by the last feasible
+   * solve, without the constant
+   *
+   * @return std::vector<double>
+   */
+  std::vector<double> getSolution();
+
   void printSolution();
 
 private:
+  // number of column blocks used by partial pricing
+  static constexpr std::size_t kPartialPricingBlocks = 4;
+
   // simplex table
   std::vector<std::vector<float>> table_;
 
@@ -43,6 +86,28 @@ private:
   // simplex basis. Order of basis must be preserved!
   std::vector<int> basis_;
 
+  // flag for each table column, true if the column is in basis_
+  std::vector<bool> is_basic_;
+
+  // pricing selected by the user, and pricing used in the current iteration
+  core::PricingStrategy pricing_strategy_;
+  core::PricingStrategy active_pricing_strategy_;
+
+  // reference weights for devex pricing
+  std::vector<float> devex_weights_;
+
+  // first column of the block searched next by partial pricing
+  std::size_t partial_pricing_start_;
+
+  // order independent hash of basis_ and hashes of all bases visited so far,
+  // used to detect cycling
+  std::uint64_t basis_hash_;
+  std::unordered_set<std::uint64_t> visited_basis_hashes_;
+
+  bool is_perturbation_enabled_;
+
+  core::SimplexStats stats_;
+
   /**
    * @brief returns a column of the table as a vector. Useful for iterating over
    *
@@ -52,16 +117,94 @@ private:
   std::vector<float> extractColumnFromTable(const int column_index);
 
   /**
-   * @brief returns the index of the smallest nonbasic entry in the objective
-   * function (first row of table_)
+   * @brief returns the index of the entering column chosen by the active
+   * pricing strategy, or -1 if no nonbasic reduced cost is negative
    *
    * @return int
    */
   int getPivotColumnIndex();
 
+  /**
+   * @brief returns the index of the first negative nonbasic entry in the
+   * objective function (first row of table_)
+   *
+   * @return int
+   */
+  int getBlandPivotColumnIndex();
+
+  /**
+   * @brief returns the index of the most negative nonbasic entry in the
+   * objective function within columns [start, end)
+   *
+   * @return int
+   */
+  int getDantzigPivotColumnIndex(const std::size_t start,
+                                 const std::size_t end);
+
+  /**
+   * @brief partial pricing: Dantzig's rule over one block of columns at a
+   * time, starting from the block after the one used last
+   *
+   * @return int
+   */
+  int getPartialPivotColumnIndex();
+
+  /**
+   * @brief returns the nonbasic column maximising d_j^2 / w_j, with w_j the
+   * devex reference weights or the exact steepest edge weights
+   * 1 + sum of squares of the column
+   *
+   * @return int
+   */
+  int getWeightedPivotColumnIndex();
+
+  /**
+   * @brief updates devex reference weights before the table is pivoted
+   *
+   * @param pivot_row_index
+   * @param pivot_column_index
+   */
+  void updateDevexWeights(const int pivot_row_index,
+                          const int pivot_column_index);
+
+  /**
+   * @brief records the current basis, returning true if it has been visited
+   * before in this solve
+   *
+   * @return bool
+   */
+  bool isBasisRepeated();
+
+  /**
+   * @brief sets the bounds column of every constraint row to a small random
+   * positive value
+   */
+  void perturbBounds();
+
+  /**
+   * @brief resets the bounds column to zero. The original bounds are all zero
+   * so B^-1 b stays zero whatever the basis
+   */
+  void removeBoundPerturbation();
+
+  /**
+   * @brief simplex iterations run by solveProblem() once the table is set up
+   *
+   * @param run_verbose
+   * @param original_problem
+   * @return core::SolveStatus
+   */
+  core::SolveStatus runSimplex(const bool run_verbose,
+                               const core::InputRows &original_problem);
+
   /**
    * @brief returns index of pivot row in table_ based on the minimum value
-   * found during ratio testing
+   * found during ratio testing. Under Bland's rule ties are broken by the
+   * smallest basic column so the solve cannot cycle, otherwise a Harris two
+   * pass test is used: the first pass finds the largest step allowed when
+   * every row may be violated by the feasibility tolerance, and the second
+   * picks the largest pivot among rows within that step. Entries below the
+   * pivot tolerance are never used
    *
    * @param pivot_column_index index found previously in getPivotColumnIndex()
    * funtion
@@ -69,6 +212,22 @@ private:
    */
   int getPivotRowIndex(const int pivot_column_index);
 
+  /**
+   * @brief textbook minimum ratio test with Bland's tie breaking
+   *
+   * @param pivot_column_index
+   * @return int
+   */
+  int getBlandPivotRowIndex(const int pivot_column_index);
+
+  /**
+   * @brief Harris two pass ratio test
+   *
+   * @param pivot_column_index
+   * @return int
+   */
+  int getHarrisPivotRowIndex(const int pivot_column_index);
+
   /**
    * @brief switch basis_ based on pivot row and column row
    *
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace utils {
+
+/**
+ * @brief hash of a single basic column. Summing it over the basis gives an
+ * order independent basis hash that can be updated in O(1) per pivot by
+ * adding the entering and subtracting the leaving column's hash
+ *
+ * @param column_index index of the basic column
+ * @return std::uint64_t
+ */
+inline std::uint64_t hashBasisColumn(const int column_index) {
+  // splitmix64 finaliser
+  std::uint64_t z =
+      static_cast<std::uint64_t>(column_index) + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+} // namespace utils
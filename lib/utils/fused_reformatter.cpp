@@ -0,0 +1,171 @@
+#include "fused_reformatter.hpp"
+
+namespace utils {
+
+FusedReformatter::FusedReformatter()
+    : num_inequality_rows_(0), num_equality_rows_(0), num_primal_variables_(0),
+      is_primal_built_(false), is_bounded_built_(false) {}
+
+void FusedReformatter::reformatProblem(const core::InputRows &input_rows) {
+  scanRows(input_rows, true);
+}
+
+void FusedReformatter::reformatPrimalProblem(
+    const core::InputRows &input_rows) {
+  scanRows(input_rows, false);
+}
+
+void FusedReformatter::scanRows(const core::InputRows &input_rows,
+                                const bool is_logical_needed) {
+
+  num_inequality_rows_ = input_rows.inequality_rows.size();
+  num_equality_rows_ = input_rows.equality_rows.size();
+  num_primal_variables_ = input_rows.num_variables - 1;
+  is_primal_built_ = false;
+  is_bounded_built_ = false;
+
+  const std::size_t num_rows = num_inequality_rows_ + num_equality_rows_;
+
+  // size buffers up front, storage is kept from previous problems
+  constants_.resize(num_rows);
+  coefficients_.resize(num_rows * num_primal_variables_);
+  if (is_logical_needed) {
+    logical_problem_.problem_matrix.resize(num_rows);
+    logical_problem_.lower_bounds.resize(num_rows);
+    logical_problem_.upper_bounds.resize(num_rows);
+  }
+
+  // single pass over inequality then equality rows
+  for (std::size_t i = 0; i < num_rows; ++i) {
+    const bool is_equality = i >= num_inequality_rows_;
+    const std::vector<float> &input_row =
+        is_equality ? input_rows.equality_rows.at(i - num_inequality_rows_)
+                    : input_rows.inequality_rows.at(i);
+
+    constants_.at(i) = input_row.at(0);
+
+    float *coefficient_row = coefficients_.data() + i * num_primal_variables_;
+    for (std::size_t j = 0; j < num_primal_variables_; ++j) {
+      coefficient_row[j] = input_row.at(j + 1);
+    }
+    if (!is_logical_needed) {
+      continue;
+    }
+
+    std::vector<int> &logical_row = logical_problem_.problem_matrix.at(i);
+    logical_row.assign(coefficient_row,
+                       coefficient_row + num_primal_variables_);
+
+    // constant is moved to the other side of the constraint
+    const int bounds_element = -1 * input_row.at(0);
+    logical_problem_.lower_bounds.at(i) = bounds_element;
+    logical_problem_.upper_bounds.at(i) =
+        is_equality ? bounds_element : core::kIntInfinity;
+  }
+}
+
+const core::FormattedLogicalProblem &
+FusedReformatter::getLogicalProblem() const {
+  return logical_problem_;
+}
+
+const core::FormattedPrimalProblem &FusedReformatter::getPrimalProblem() {
+  if (!is_primal_built_) {
+    buildPrimalProblem();
+    is_primal_built_ = true;
+  }
+  return primal_problem_;
+}
+
+const core::FormattedBoundedProblem &FusedReformatter::getBoundedProblem() {
+  if (!is_bounded_built_) {
+    buildBoundedProblem();
+    is_bounded_built_ = true;
+  }
+  return bounded_problem_;
+}
+
+void FusedReformatter::buildBoundedProblem() {
+  const std::size_t num_rows = num_inequality_rows_ + num_equality_rows_;
+
+  bounded_problem_.problem_matrix.resize(num_rows);
+  bounded_problem_.row_lower_bounds.resize(num_rows);
+  bounded_problem_.row_upper_bounds.resize(num_rows);
+
+  for (std::size_t i = 0; i < num_rows; ++i) {
+    const float *coefficient_row =
+        coefficients_.data() + i * num_primal_variables_;
+    bounded_problem_.problem_matrix.at(i).assign(
+        coefficient_row, coefficient_row + num_primal_variables_);
+
+    // a x + c >= 0 for inequalities and a x + c = 0 for equalities
+    const double bound = -1.0 * constants_.at(i);
+    bounded_problem_.row_lower_bounds.at(i) = bound;
+    bounded_problem_.row_upper_bounds.at(i) =
+        i >= num_inequality_rows_ ? bound : core::kFloatInfinity;
+  }
+
+  // variables are free
+  bounded_problem_.column_lower_bounds.assign(num_primal_variables_,
+                                              -core::kFloatInfinity);
+  bounded_problem_.column_upper_bounds.assign(num_primal_variables_,
+                                              core::kFloatInfinity);
+}
+
+void FusedReformatter::buildPrimalProblem() {
+
+  // the primal table holds inequality rows, equality rows and negated equality
+  // rows. The dual table is its transpose for x+ and again negated for x-,
+  // with slack identity, a leading objective column and a bounds column
+  const std::size_t num_input_rows = num_inequality_rows_ + num_equality_rows_;
+  const std::size_t num_primal_rows = num_input_rows + num_equality_rows_;
+  const std::size_t num_table_rows = 2 * num_primal_variables_ + 1;
+  const std::size_t row_length = num_primal_rows + 2 * num_primal_variables_ + 2;
+  const std::size_t slack_start = num_primal_rows + 1;
+
+  std::vector<std::vector<float>> &table = primal_problem_.problem_matrix;
+  table.resize(num_table_rows);
+  for (std::size_t i = 0; i < num_table_rows; ++i) {
+    table.at(i).assign(row_length, 0);
+  }
+
+  // objective row holds the negated primal bounds
+  std::vector<float> &objective_row = table.at(0);
+  objective_row.at(0) = 1;
+  for (std::size_t k = 0; k < num_input_rows; ++k) {
+    objective_row.at(k + 1) = constants_.at(k);
+  }
+  for (std::size_t k = 0; k < num_equality_rows_; ++k) {
+    objective_row.at(num_input_rows + k + 1) =
+        -1.0F * constants_.at(num_inequality_rows_ + k);
+  }
+
+  // transposed entries for x+ in rows 1..n and for x- in rows n+1..2n
+  for (std::size_t i = 0; i < num_primal_variables_; ++i) {
+    std::vector<float> &positive_row = table.at(i + 1);
+    std::vector<float> &negative_row = table.at(i + 1 + num_primal_variables_);
+
+    for (std::size_t k = 0; k < num_input_rows; ++k) {
+      const float coefficient = coefficients_.at(k * num_primal_variables_ + i);
+      positive_row.at(k + 1) = coefficient;
+      negative_row.at(k + 1) = -1.0F * coefficient;
+    }
+    for (std::size_t k = 0; k < num_equality_rows_; ++k) {
+      const float coefficient = coefficients_.at(
+          (num_inequality_rows_ + k) * num_primal_variables_ + i);
+      positive_row.at(num_input_rows + k + 1) = -1.0F * coefficient;
+      negative_row.at(num_input_rows + k + 1) = coefficient;
+    }
+
+    positive_row.at(slack_start + i) = 1;
+    negative_row.at(slack_start + num_primal_variables_ + i) = 1;
+  }
+
+  // initial basis is the slack column of each table row
+  primal_problem_.basic_variables.clear();
+  for (std::size_t i = slack_start; i < row_length - 1; ++i) {
+    primal_problem_.basic_variables.push_back(i);
+  }
+}
+
+} // namespace utils
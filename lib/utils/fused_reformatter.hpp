@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../core/consts.hpp"
+#include "../core/types.hpp"
+
+namespace utils {
+
+class FusedReformatter {
+public:
+  FusedReformatter();
+
+  /**
+   * @brief scans the input rows once, writing the logical problem and the
+   * coefficient buffers the primal problem is later built from. Buffers are
+   * kept between calls so their storage is reused across problems
+   *
+   * @param input_rows problem as returned by the reader
+   */
+  void reformatProblem(const core::InputRows &input_rows);
+
+  /**
+   * @brief scans the input rows once for the primal and bounded problems
+   * only, leaving the logical problem as it was. For solvers that never need
+   * the logical form
+   *
+   * @param input_rows problem as returned by the reader
+   */
+  void reformatPrimalProblem(const core::InputRows &input_rows);
+
+  /**
+   * @brief returns the logical (presolve) form of the last problem passed to
+   * reformatProblem()
+   *
+   * @return const core::FormattedLogicalProblem&
+   */
+  const core::FormattedLogicalProblem &getLogicalProblem() const;
+
+  /**
+   * @brief returns the primal simplex form of the last problem passed to
+   * reformatProblem(), identical to the output of PrimalReformatter. The table
+   * is only built on the first call for each problem, so problems solved by
+   * presolve never pay for it
+   *
+   * @return const core::FormattedPrimalProblem&
+   */
+  const core::FormattedPrimalProblem &getPrimalProblem();
+
+  /**
+   * @brief returns the bounded form of the last problem passed to
+   * reformatProblem(): one row per input row with the constant moved into the
+   * row bounds, and free columns. Built on the first call for each problem
+   *
+   * @return const core::FormattedBoundedProblem&
+   */
+  const core::FormattedBoundedProblem &getBoundedProblem();
+
+private:
+  /**
+   * @brief fills the coefficient buffers from the input rows, and the logical
+   * problem too if asked to
+   *
+   * @param input_rows
+   * @param is_logical_needed
+   */
+  void scanRows(const core::InputRows &input_rows,
+                const bool is_logical_needed);
+
+  /**
+   * @brief builds the full dual table and initial basis from the contiguous
+   * constants_ and coefficients_ buffers
+   */
+  void buildPrimalProblem();
+
+  /**
+   * @brief builds the bounded problem from the contiguous buffers
+   */
+  void buildBoundedProblem();
+
+  core::FormattedLogicalProblem logical_problem_;
+  core::FormattedPrimalProblem primal_problem_;
+  core::FormattedBoundedProblem bounded_problem_;
+
+  // constant term of each input row, inequalities first
+  std::vector<float> constants_;
+
+  // row major coefficients of each input row (constant term removed)
+  std::vector<float> coefficients_;
+
+  std::size_t num_inequality_rows_;
+  std::size_t num_equality_rows_;
+  std::size_t num_primal_variables_;
+
+  // whether primal_problem_ is up to date with the current problem
+  bool is_primal_built_;
+  bool is_bounded_built_;
+};
+
+} // namespace utils
@@ -189,9 +189,9 @@ core::FormattedPrimalProblem PrimalReformatter::getFullDualTable(
     temp_row.clear();
   }
 
-  // Get intial basis
+  // Get intial basis, one slack column per table row
   std::vector<int> initial_basis;
-  for (std::size_t i = primal_table.size() + 1; i < objective_row.size() - 2;
+  for (std::size_t i = primal_table.size() + 1; i < objective_row.size() - 1;
        ++i) {
     initial_basis.push_back(i);
   }
@@ -2,22 +2,26 @@
 #include <iostream>
 
 namespace utils {
-// Must be initialised with OPEN filestream
-ModifiedPrimalReader::ModifiedPrimalReader(std::fstream &filestream)
+// Must be initialised with OPEN filestream, or any other input stream such
+// as std::cin or a named pipe
+ModifiedPrimalReader::ModifiedPrimalReader(std::istream &filestream)
     : filestream_(filestream), current_probelm_number_(0) {}
 
 std::optional<core::InputRows> ModifiedPrimalReader::getNextProblem() {
 
-  if (!filestream_.is_open()) {
-    std::cout << "ERROR: Unable to open file" << std::endl;
+  if (!filestream_ && !filestream_.eof()) {
+    std::cerr << "ERROR: Unable to open file" << std::endl;
   }
   // initialise strings for storing elements read from file
   std::string temp_string;
   std::string num_variables_string;
   std::string num_inequality_rows_string;
 
-  // get number of variables and number of inequalities we are reading in
-  std::getline(filestream_, num_variables_string);
+  // get number of variables and number of inequalities we are reading in,
+  // the stream ending here is the end of the problems rather than an error
+  if (!std::getline(filestream_, num_variables_string)) {
+    return std::nullopt;
+  }
   const int num_variables = atoi(num_variables_string.c_str()) + 1;
 
   std::getline(filestream_, num_inequality_rows_string);
@@ -54,8 +58,8 @@ std::optional<core::InputRows> ModifiedPrimalReader::getNextProblem() {
   // check we are where we think we are in problem
   std::getline(filestream_, temp_string);
   if (temp_string.find(tilde_) == std::string::npos) {
-    std::cout << "Error: Unable to deduce location in problem" << std::endl;
-    std::cout << "Last known problem location: " << current_probelm_number_
+    std::cerr << "Error: Unable to deduce location in problem" << std::endl;
+    std::cerr << "Last known problem location: " << current_probelm_number_
               << std::endl;
     return std::nullopt;
   }
@@ -1,7 +1,7 @@
 #include "../core/consts.hpp"
 #include "../core/types.hpp"
 #include <cstdint>
-#include <fstream>
+#include <istream>
 #include <optional>
 #include <string>
 #include <vector>
@@ -10,11 +10,12 @@ namespace utils {
 
 class ModifiedPrimalReader {
 public:
-  ModifiedPrimalReader(std::fstream &filestream);
+  ModifiedPrimalReader(std::istream &filestream);
 
   /**
    * @brief returns next problem in file in InputRows format
-   * fails if location in problem file is lost
+   * fails if location in problem file is lost, and returns nothing once the
+   * stream has ended
    */
   std::optional<core::InputRows> getNextProblem();
 
@@ -29,7 +30,7 @@ private:
    */
   std::vector<float> convertStringToVector(const std::string vector_string);
 
-  std::fstream &filestream_;
+  std::istream &filestream_;
 
   // counter of filestream problem number, initialised as 0
   uint64_t current_probelm_number_;
@@ -0,0 +1,185 @@
+#include "results_writer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace utils {
+
+const char *getSolveStatusName(const core::SolveStatus solve_status) {
+  switch (solve_status) {
+  case core::SolveStatus::kFeasible:
+    return "feasible";
+  case core::SolveStatus::kInfeasible:
+    return "infeasible";
+  case core::SolveStatus::kDidntConverge:
+    return "didnt_converge";
+  default:
+    return "error";
+  }
+}
+
+ResultsWriter::ResultsWriter()
+    : format_(ResultsFormat::kCsv), is_closing_(false) {}
+
+ResultsWriter::~ResultsWriter() { close(); }
+
+std::optional<ResultsFormat> ResultsWriter::getFormat(const std::string &path) {
+  const std::size_t dot = path.rfind('.');
+  if (dot == std::string::npos) {
+    return std::nullopt;
+  }
+  const std::string extension = path.substr(dot);
+  if (extension == ".csv") {
+    return ResultsFormat::kCsv;
+  }
+  if (extension == ".jsonl") {
+    return ResultsFormat::kJsonl;
+  }
+  if (extension == ".bin") {
+    return ResultsFormat::kBinary;
+  }
+  return std::nullopt;
+}
+
+bool ResultsWriter::open(const std::string &path) {
+  close();
+  const std::optional<ResultsFormat> format = getFormat(path);
+  if (!format) {
+    return false;
+  }
+  format_ = *format;
+  file_.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file_.is_open()) {
+    return false;
+  }
+
+  if (format_ == ResultsFormat::kCsv) {
+    file_ << "index,status,engine,iterations,time_nanos,solution\n";
+  } else if (format_ == ResultsFormat::kBinary) {
+    const std::uint32_t version = 1;
+    file_.write("LPRESULT", 8);
+    file_.write(reinterpret_cast<const char *>(&version), sizeof(version));
+  }
+  buffer_.precision(std::numeric_limits<double>::max_digits10);
+  is_closing_ = false;
+  pending_.reserve(core::kResultsBatchSize);
+  writer_ = std::thread(&ResultsWriter::runWriter, this);
+  return true;
+}
+
+bool ResultsWriter::isOpen() const { return file_.is_open(); }
+
+void ResultsWriter::addResult(core::ProblemResult &&result) {
+  pending_.push_back(std::move(result));
+  if (pending_.size() < static_cast<std::size_t>(core::kResultsBatchSize)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_.push_back(std::move(pending_));
+  }
+  condition_.notify_one();
+  pending_.clear();
+  pending_.reserve(core::kResultsBatchSize);
+}
+
+void ResultsWriter::close() {
+  if (!file_.is_open()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_.empty()) {
+      batches_.push_back(std::move(pending_));
+      pending_.clear();
+    }
+    is_closing_ = true;
+  }
+  condition_.notify_one();
+  writer_.join();
+  file_.close();
+}
+
+void ResultsWriter::runWriter() {
+  for (;;) {
+    std::vector<core::ProblemResult> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return is_closing_ || !batches_.empty(); });
+      if (batches_.empty()) {
+        return;
+      }
+      batch = std::move(batches_.front());
+      batches_.pop_front();
+    }
+
+    buffer_.str("");
+    for (const core::ProblemResult &result : batch) {
+      switch (format_) {
+      case ResultsFormat::kCsv:
+        writeCsv(result);
+        break;
+      case ResultsFormat::kJsonl:
+        writeJsonl(result);
+        break;
+      case ResultsFormat::kBinary:
+        writeBinary(result);
+        break;
+      }
+    }
+    const std::string text = buffer_.str();
+    file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+  }
+}
+
+void ResultsWriter::writeCsv(const core::ProblemResult &result) {
+  buffer_ << result.index << "," << getSolveStatusName(result.status) << ","
+          << result.engine << "," << result.num_iterations << ","
+          << result.time_nanos << ",";
+  for (std::size_t j = 0; j < result.solution.size(); ++j) {
+    if (j > 0) {
+      buffer_ << " ";
+    }
+    buffer_ << result.solution[j];
+  }
+  buffer_ << "\n";
+}
+
+void ResultsWriter::writeJsonl(const core::ProblemResult &result) {
+  buffer_ << "{\"index\":" << result.index << ",\"status\":\""
+          << getSolveStatusName(result.status) << "\",\"engine\":\""
+          << result.engine << "\",\"iterations\":" << result.num_iterations
+          << ",\"time_nanos\":" << result.time_nanos << ",\"solution\":[";
+  for (std::size_t j = 0; j < result.solution.size(); ++j) {
+    if (j > 0) {
+      buffer_ << ",";
+    }
+    // JSON has no infinities or NaN
+    if (std::isfinite(result.solution[j])) {
+      buffer_ << result.solution[j];
+    } else {
+      buffer_ << "null";
+    }
+  }
+  buffer_ << "]}\n";
+}
+
+void ResultsWriter::writeBinary(const core::ProblemResult &result) {
+  writeBytes(static_cast<std::uint64_t>(result.index));
+  writeBytes(static_cast<std::uint8_t>(result.status));
+  const std::uint8_t engine_length =
+      static_cast<std::uint8_t>(std::min<std::size_t>(result.engine.size(),
+                                                      255));
+  writeBytes(engine_length);
+  buffer_.write(result.engine.data(), engine_length);
+  writeBytes(static_cast<std::int64_t>(result.num_iterations));
+  writeBytes(static_cast<std::uint64_t>(result.time_nanos));
+  writeBytes(static_cast<std::uint32_t>(result.solution.size()));
+  buffer_.write(reinterpret_cast<const char *>(result.solution.data()),
+                static_cast<std::streamsize>(result.solution.size() *
+                                             sizeof(double)));
+}
+
+} // namespace utils
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/consts.hpp"
+#include "../core/types.hpp"
+
+namespace utils {
+
+enum class ResultsFormat { kCsv, kJsonl, kBinary };
+
+/**
+ * @brief name of a verdict in results and result lines
+ *
+ * @param solve_status
+ * @return const char*
+ */
+const char *getSolveStatusName(const core::SolveStatus solve_status);
+
+/**
+ * @brief Writes one record per problem to a results file on a thread of its
+ * own. Results are handed over kResultsBatchSize at a time, so the solve loop
+ * only moves them into a buffer and the formatting and writing happen
+ * alongside it.
+ *
+ * CSV has a header line and the solution as space separated values in its
+ * last field. JSONL has one object per line with the solution as an array.
+ * The binary format starts with the 8 bytes "LPRESULT" and a uint32 version,
+ * then each record is index as uint64, status as uint8, the engine name as
+ * its uint8 length and bytes, iterations as int64, time in nanoseconds as
+ * uint64, and the solution as its uint32 length and doubles, all in native
+ * byte order
+ */
+class ResultsWriter {
+public:
+  ResultsWriter();
+
+  ~ResultsWriter();
+
+  /**
+   * @brief returns the format given by the extension of a path: .csv,
+   * .jsonl or .bin
+   *
+   * @param path
+   * @return std::optional<ResultsFormat>
+   */
+  static std::optional<ResultsFormat> getFormat(const std::string &path);
+
+  /**
+   * @brief Open a results file, in the format its extension gives, and start
+   * the writer thread
+   *
+   * @param path
+   * @return bool whether the file could be opened in a known format
+   */
+  bool open(const std::string &path);
+
+  /**
+   * @brief returns whether a file is open for results
+   *
+   * @return bool
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Queue the result of a problem, handing the batch to the writer
+   * thread once it holds kResultsBatchSize of them
+   *
+   * @param result
+   */
+  void addResult(core::ProblemResult &&result);
+
+  /**
+   * @brief Write what is queued, stop the writer thread and close the file
+   *
+   */
+  void close();
+
+private:
+  ResultsFormat format_;
+  std::ofstream file_;
+  std::thread writer_;
+
+  // results queued by the solve loop, not yet handed over
+  std::vector<core::ProblemResult> pending_;
+
+  // batches handed over, waiting for the writer thread
+  std::deque<std::vector<core::ProblemResult>> batches_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool is_closing_;
+
+  // text of the batch being written, reused between batches
+  std::ostringstream buffer_;
+
+  /**
+   * @brief Write batches as they are handed over until closing
+   *
+   */
+  void runWriter();
+
+  void writeCsv(const core::ProblemResult &result);
+
+  void writeJsonl(const core::ProblemResult &result);
+
+  void writeBinary(const core::ProblemResult &result);
+
+  /**
+   * @brief append the bytes of a value to the buffer
+   *
+   * @tparam T
+   * @param value
+   */
+  template <typename T> void writeBytes(const T &value) {
+    buffer_.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+};
+
+} // namespace utils
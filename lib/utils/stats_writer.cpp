@@ -0,0 +1,90 @@
+#include "stats_writer.hpp"
+
+namespace utils {
+
+std::string getPresolveRuleName(const core::PresolveRulesIds rule_id) {
+  switch (rule_id) {
+  case core::PresolveRulesIds::freeRowId:
+    return "free_row";
+  case core::PresolveRulesIds::rowAndColSingletonId:
+    return "row_and_col_singleton";
+  case core::PresolveRulesIds::rowSingletonId:
+    return "row_singleton";
+  case core::PresolveRulesIds::parallelRowId:
+    return "parallel_row";
+  case core::PresolveRulesIds::emptyColId:
+    return "empty_col";
+  case core::PresolveRulesIds::fixedColId:
+    return "fixed_col";
+  case core::PresolveRulesIds::freeColSubsId:
+    return "free_col_substitution";
+  case core::PresolveRulesIds::emptyRowId:
+    return "empty_row";
+  case core::PresolveRulesIds::redundantRowId:
+    return "redundant_row";
+  case core::PresolveRulesIds::forcingRowId:
+    return "forcing_row";
+  case core::PresolveRulesIds::doubletonEquationId:
+    return "doubleton_equation";
+  case core::PresolveRulesIds::parallelColId:
+    return "parallel_col";
+  case core::PresolveRulesIds::dominatedColId:
+    return "dominated_col";
+  }
+  return "unknown";
+}
+
+void addPresolveStats(core::PresolveStats &total,
+                      const core::PresolveStats &stats) {
+  total.rule_stats.resize(core::kNumPresolveRules, core::PresolveRuleStats());
+  for (std::size_t i = 0; i < stats.rule_stats.size(); ++i) {
+    core::PresolveRuleStats &total_rule = total.rule_stats.at(i);
+    const core::PresolveRuleStats &rule = stats.rule_stats.at(i);
+    total_rule.num_applications += rule.num_applications;
+    total_rule.num_rows_removed += rule.num_rows_removed;
+    total_rule.num_cols_removed += rule.num_cols_removed;
+    total_rule.time_nanos += rule.time_nanos;
+  }
+  total.num_iterations += stats.num_iterations;
+  total.row_rules_time_nanos += stats.row_rules_time_nanos;
+  total.activity_rules_time_nanos += stats.activity_rules_time_nanos;
+  total.col_rules_time_nanos += stats.col_rules_time_nanos;
+  total.parallel_col_rules_time_nanos += stats.parallel_col_rules_time_nanos;
+  total.doubleton_rules_time_nanos += stats.doubleton_rules_time_nanos;
+  total.postsolve_time_nanos += stats.postsolve_time_nanos;
+}
+
+void writePresolveStatsJson(std::ostream &out, const core::PresolveStats &stats,
+                            const int num_problems) {
+  out << "{\n";
+  out << "  \"num_problems\": " << num_problems << ",\n";
+  out << "  \"num_iterations\": " << stats.num_iterations << ",\n";
+
+  out << "  \"rules\": {";
+  for (std::size_t i = 0; i < stats.rule_stats.size(); ++i) {
+    const core::PresolveRuleStats &rule = stats.rule_stats.at(i);
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    \""
+        << getPresolveRuleName(static_cast<core::PresolveRulesIds>(i))
+        << "\": {\"applications\": " << rule.num_applications
+        << ", \"rows_removed\": " << rule.num_rows_removed
+        << ", \"cols_removed\": " << rule.num_cols_removed
+        << ", \"time_nanos\": " << rule.time_nanos << "}";
+  }
+  out << "\n  },\n";
+
+  out << "  \"phase_time_nanos\": {\n";
+  out << "    \"row_rules\": " << stats.row_rules_time_nanos << ",\n";
+  out << "    \"activity_rules\": " << stats.activity_rules_time_nanos
+      << ",\n";
+  out << "    \"col_rules\": " << stats.col_rules_time_nanos << ",\n";
+  out << "    \"parallel_col_rules\": " << stats.parallel_col_rules_time_nanos
+      << ",\n";
+  out << "    \"doubleton_rules\": " << stats.doubleton_rules_time_nanos
+      << ",\n";
+  out << "    \"postsolve\": " << stats.postsolve_time_nanos << "\n";
+  out << "  }\n";
+  out << "}\n";
+}
+
+} // namespace utils
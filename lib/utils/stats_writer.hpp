@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "../core/types.hpp"
+
+namespace utils {
+
+/**
+ * @brief name of a presolve rule as used in reports
+ *
+ * @param rule_id
+ * @return std::string
+ */
+std::string getPresolveRuleName(const core::PresolveRulesIds rule_id);
+
+/**
+ * @brief adds the counters of one presolve run to a running total. The
+ * total's rule stats are sized on first use
+ *
+ * @param total stats summed so far
+ * @param stats stats of a single presolve run
+ */
+void addPresolveStats(core::PresolveStats &total,
+                      const core::PresolveStats &stats);
+
+/**
+ * @brief writes presolve stats as a JSON object with one entry per rule and
+ * the time spent in each presolve phase
+ *
+ * @param out stream to write to
+ * @param stats stats to write, usually summed over a run
+ * @param num_problems number of problems the stats were gathered over
+ */
+void writePresolveStatsJson(std::ostream &out, const core::PresolveStats &stats,
+                            const int num_problems);
+
+} // namespace utils
@@ -0,0 +1,91 @@
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+// Client of run_main --serve=<socket>: sends the problems of a file, or of
+// stdin without one, and prints the result lines the server sends back, as
+// they arrive, until the server has answered every problem
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: run_client <socket> [problem file]" << std::endl;
+    return 1;
+  }
+  const std::string socket_path = argv[1];
+
+  std::ifstream problem_file;
+  if (argc > 2) {
+    problem_file.open(argv[2], std::ios::binary);
+    if (!problem_file.is_open()) {
+      std::cerr << "Could not open " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+  std::istream &problem_stream = argc > 2 ? problem_file : std::cin;
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Socket path " << socket_path << " is too long" << std::endl;
+    return 1;
+  }
+  std::strcpy(address.sun_path, socket_path.c_str());
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                          sizeof(address)) < 0) {
+    std::cerr << "Could not connect to " << socket_path << ": "
+              << std::strerror(errno) << std::endl;
+    return 1;
+  }
+
+  // problems are sent while results are read, so that neither side blocks
+  // on a full socket buffer
+  std::thread sender([fd, &problem_stream] {
+    char buffer[1 << 16];
+    while (problem_stream) {
+      problem_stream.read(buffer, sizeof(buffer));
+      std::streamsize num_read = problem_stream.gcount();
+      const char *data = buffer;
+      while (num_read > 0) {
+        const ssize_t count = ::send(fd, data, num_read, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+          continue;
+        }
+        if (count <= 0) {
+          std::cerr << "Could not send: " << std::strerror(errno)
+                    << std::endl;
+          ::shutdown(fd, SHUT_WR);
+          return;
+        }
+        data += count;
+        num_read -= count;
+      }
+    }
+    // tells the server no more problems are coming
+    ::shutdown(fd, SHUT_WR);
+  });
+
+  char buffer[1 << 16];
+  for (;;) {
+    const ssize_t count = ::read(fd, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    std::cout.write(buffer, count);
+    std::cout.flush();
+  }
+
+  sender.join();
+  ::close(fd);
+  return 0;
+}
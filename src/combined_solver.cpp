@@ -1,5 +1,416 @@
 #include "combined_solver.hpp"
 
+void CombinedRun::setPricingStrategy(
+    const core::PricingStrategy pricing_strategy) {
+  pricing_strategy_ = pricing_strategy;
+}
+
+void CombinedRun::setPerturbation(const bool is_perturbation_enabled) {
+  is_perturbation_enabled_ = is_perturbation_enabled;
+}
+
+void CombinedRun::setPresolveStatsPath(const std::string presolve_stats_path) {
+  presolve_stats_path_ = presolve_stats_path;
+}
+
+void CombinedRun::setIntegerMode(const bool is_integer_mode) {
+  is_integer_mode_ = is_integer_mode;
+}
+
+void CombinedRun::setFourierMotzkin(const bool is_fourier_motzkin_enabled) {
+  is_fourier_motzkin_enabled_ = is_fourier_motzkin_enabled;
+}
+
+void CombinedRun::setInteriorPoint(const bool is_interior_point_enabled) {
+  is_interior_point_enabled_ = is_interior_point_enabled;
+}
+
+void CombinedRun::setPdhg(const bool is_pdhg_enabled) {
+  is_pdhg_enabled_ = is_pdhg_enabled;
+}
+
+bool CombinedRun::setPipeline(const std::string &pipeline) {
+  pipeline_ = pipeline;
+  return solver_registry_.isValidPipeline(pipeline);
+}
+
+std::vector<std::string> CombinedRun::getSolverNames() const {
+  return solver_registry_.getNames();
+}
+
+void CombinedRun::setStreamSolution(const bool is_stream_solution_enabled) {
+  is_stream_solution_enabled_ = is_stream_solution_enabled;
+}
+
+bool CombinedRun::setResultsPath(const std::string &results_path) {
+  results_path_ = results_path;
+  return utils::ResultsWriter::getFormat(results_path).has_value();
+}
+
+bool CombinedRun::setPolicyPath(const std::string &policy_path) {
+  std::ifstream policy_file(policy_path);
+  if (!policy_file.is_open() || !policy_.readTable(policy_file)) {
+    return false;
+  }
+  for (const std::string &pipeline : policy_.getPipelines()) {
+    if (!solver_registry_.isValidPipeline(pipeline)) {
+      return false;
+    }
+  }
+  is_policy_set_ = true;
+  return true;
+}
+
+void CombinedRun::addStats(const core::SimplexStats &stats) {
+  result_iterations_ += stats.num_iterations;
+  total_stats_.num_iterations += stats.num_iterations;
+  total_stats_.num_degenerate_iterations += stats.num_degenerate_iterations;
+  total_stats_.num_repeated_bases += stats.num_repeated_bases;
+  if (stats.is_perturbed) {
+    ++num_perturbed_;
+  }
+}
+
+void CombinedRun::countSolveStatus(const core::SolveStatus solve_status) {
+  switch (solve_status) {
+  case core::SolveStatus::kDidntConverge:
+    ++num_didnt_converge_;
+    break;
+
+  case core::SolveStatus::kFeasible:
+    ++num_sucessfully_solved_;
+    break;
+
+  case core::SolveStatus::kInfeasible:
+    ++num_infeasible_;
+    break;
+
+  default:
+    ++num_error_;
+    break;
+  }
+}
+
+void CombinedRun::writeProblemResult(const core::SolveStatus solve_status,
+                                     const std::string &engine,
+                                     const std::vector<double> &solution) {
+  if (!results_writer_.isOpen()) {
+    return;
+  }
+  const std::uint64_t time_nanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - result_start_)
+          .count();
+  results_writer_.addResult({result_index_, solve_status, engine,
+                             result_iterations_, time_nanos, solution});
+}
+
+bool CombinedRun::solveInteriorPoint(
+    const core::InputRows &problem,
+    solvers::interior_point::InteriorPoint &interior_point_solver) {
+  interior_point_solver.setProblem(problem);
+  const core::SolveStatus solve_state = interior_point_solver.solveProblem();
+  ++num_interior_point_solves_;
+  num_interior_point_iterations_ += interior_point_solver.getIterationCount();
+  result_iterations_ += interior_point_solver.getIterationCount();
+  if (solve_state != core::SolveStatus::kFeasible &&
+      solve_state != core::SolveStatus::kInfeasible) {
+    return false;
+  }
+  countSolveStatus(solve_state);
+  writeProblemResult(solve_state, "interior_point",
+                     interior_point_solver.getSolution());
+  return true;
+}
+
+bool CombinedRun::solvePdhg(
+    const core::InputRows &problem,
+    solvers::pdhg::PrimalDualHybridGradient &pdhg_solver) {
+  pdhg_solver.setProblem(problem);
+  const core::SolveStatus solve_state = pdhg_solver.solveProblem();
+  ++num_pdhg_solves_;
+  num_pdhg_iterations_ += pdhg_solver.getIterationCount();
+  result_iterations_ += pdhg_solver.getIterationCount();
+  if (solve_state != core::SolveStatus::kFeasible &&
+      solve_state != core::SolveStatus::kInfeasible) {
+    return false;
+  }
+  countSolveStatus(solve_state);
+  writeProblemResult(solve_state, "pdhg", pdhg_solver.getSolution());
+  return true;
+}
+
+void CombinedRun::setPipelineProblem(core::InputRows &&problem,
+                                     core::PipelineProblem &pipeline_problem) {
+  pipeline_problem.rows = std::move(problem);
+  pipeline_problem.is_bounded_set = false;
+  pipeline_problem.is_reduced = false;
+  pipeline_problem.simplex_stats.clear();
+  pipeline_problem.interior_point_iterations.clear();
+  pipeline_problem.pdhg_iterations.clear();
+  pipeline_problem.is_presolved = false;
+}
+
+solvers::pipeline::SolverPipeline *
+CombinedRun::selectPipeline(const core::InputRows &problem) {
+  std::string pipeline_name = pipeline_;
+  if (pipeline_name.empty() && is_policy_set_) {
+    pipeline_name = policy_.getPipeline(
+        solvers::pipeline::SelectionPolicy::getFeatures(problem));
+    ++num_policy_picks_[pipeline_name];
+  } else if (pipeline_name.empty()) {
+    pipeline_name = solvers::pipeline::SelectionPolicy::kDefaultPipeline;
+  }
+
+  auto pipeline = pipelines_.find(pipeline_name);
+  if (pipeline == pipelines_.end()) {
+    std::optional<solvers::pipeline::SolverPipeline> created_pipeline =
+        solver_registry_.createPipeline(
+            pipeline_name, {pricing_strategy_, is_perturbation_enabled_});
+    if (!created_pipeline) {
+      std::cerr << "Could not build pipeline " << pipeline_name << std::endl;
+      return nullptr;
+    }
+    pipeline =
+        pipelines_.emplace(pipeline_name, std::move(*created_pipeline)).first;
+  }
+  return &pipeline->second;
+}
+
+core::SolveStatus
+CombinedRun::solvePipeline(core::InputRows &&problem,
+                           solvers::pipeline::SolverPipeline &pipeline,
+                           core::PipelineProblem &pipeline_problem) {
+  setPipelineProblem(std::move(problem), pipeline_problem);
+  const core::SolveStatus solve_state =
+      pipeline.solveProblem(pipeline_problem);
+  countSolveStatus(solve_state);
+  for (const core::SimplexStats &stats : pipeline_problem.simplex_stats) {
+    addStats(stats);
+  }
+  for (const int num_iterations : pipeline_problem.interior_point_iterations) {
+    ++num_interior_point_solves_;
+    num_interior_point_iterations_ += num_iterations;
+    result_iterations_ += num_iterations;
+  }
+  for (const int num_iterations : pipeline_problem.pdhg_iterations) {
+    ++num_pdhg_solves_;
+    num_pdhg_iterations_ += num_iterations;
+    result_iterations_ += num_iterations;
+  }
+  writeProblemResult(solve_state, pipeline.getVerdictStageName(),
+                     pipeline_problem.variable_values);
+  if (pipeline_problem.is_presolved) {
+    ++num_presolved_;
+    utils::addPresolveStats(total_presolve_stats_,
+                            pipeline_problem.presolve_stats);
+  }
+  return solve_state;
+}
+
+void CombinedRun::finishReducedSolve(
+    const core::InputRows &problem, logical_solver::Presolve &presolve,
+    const bool is_reduced, core::SolveStatus solve_state,
+    const std::vector<double> &solution, const char *engine,
+    solvers::bland_simplex::BlandPrimalSimplex &simplex_solver,
+    utils::FusedReformatter &rf) {
+  // recover the solution of the full problem from the reduced one
+  if (is_reduced) {
+    if (solve_state == core::SolveStatus::kFeasible) {
+      presolve.setReducedSolution(solution);
+    }
+    presolve.applyPostsolve();
+  }
+
+  // no verdict from the dual, try bland's rule on the full problem unless
+  // it is too large for the dense table
+  const bool is_primal_solve =
+      (solve_state == core::SolveStatus::kDidntConverge ||
+       solve_state == core::SolveStatus::kError) &&
+      problem.num_variables - 1 <= core::kPrimalFallbackMaxVariables;
+  if (is_primal_solve) {
+    // rf still holds the rows scanned for presolve, the table is built from
+    // them without scanning the problem again
+    const core::FormattedPrimalProblem &rf_prob = rf.getPrimalProblem();
+    simplex_solver.setProblem(rf_prob.problem_matrix);
+    simplex_solver.setBasis(rf_prob.basic_variables);
+    solve_state = simplex_solver.solveProblem(false, problem);
+    addStats(simplex_solver.getStats());
+
+    // stalling on the degenerate table, retry with perturbed bounds
+    if (solve_state == core::SolveStatus::kDidntConverge &&
+        !is_perturbation_enabled_) {
+      simplex_solver.setProblem(rf_prob.problem_matrix);
+      simplex_solver.setBasis(rf_prob.basic_variables);
+      simplex_solver.setPerturbation(true);
+      solve_state = simplex_solver.solveProblem(false, problem);
+      simplex_solver.setPerturbation(false);
+      addStats(simplex_solver.getStats());
+    }
+  }
+
+  countSolveStatus(solve_state);
+  utils::addPresolveStats(total_presolve_stats_, presolve.getStats());
+
+  // the values of the variables come from the primal simplex, from
+  // postsolve, or are the solution itself when presolve did not reduce
+  if (results_writer_.isOpen()) {
+    std::vector<double> variable_values;
+    if (solve_state == core::SolveStatus::kFeasible) {
+      if (is_primal_solve) {
+        variable_values = simplex_solver.getSolution();
+      } else if (!is_reduced) {
+        variable_values = solution;
+      } else if (!presolve.unsatisfied_constraints_) {
+        variable_values = presolve.getFeasibleSolution();
+      }
+    }
+    writeProblemResult(solve_state, is_primal_solve ? "primal" : engine,
+                       variable_values);
+  }
+}
+
+void CombinedRun::writePresolveStats() {
+  if (presolve_stats_path_.empty()) {
+    return;
+  }
+  std::ofstream stats_file(presolve_stats_path_);
+  if (!stats_file.is_open()) {
+    std::cout << "Could not open " << presolve_stats_path_ << std::endl;
+    return;
+  }
+  utils::writePresolveStatsJson(stats_file, total_presolve_stats_,
+                                num_presolved_);
+}
+
+void CombinedRun::tunePolicy(const std::string problems_filepath,
+                             const std::string policy_path) {
+  std::fstream filestream;
+  filestream.open(problems_filepath, std::ios::in);
+  utils::ModifiedPrimalReader reader_(filestream);
+
+  solvers::pipeline::PolicyTuner tuner(
+      solvers::pipeline::PolicyTuner::kCandidatePipelines);
+  std::vector<solvers::pipeline::SolverPipeline> pipelines;
+  for (const std::string &candidate : tuner.getCandidates()) {
+    std::optional<solvers::pipeline::SolverPipeline> pipeline =
+        solver_registry_.createPipeline(
+            candidate, {pricing_strategy_, is_perturbation_enabled_});
+    if (!pipeline) {
+      std::cout << "Could not build pipeline " << candidate << std::endl;
+      return;
+    }
+    pipelines.push_back(std::move(*pipeline));
+  }
+  core::PipelineProblem pipeline_problem;
+  std::vector<std::uint64_t> times_nanos(pipelines.size());
+  std::vector<core::SolveStatus> solve_statuses(pipelines.size());
+
+  int num_to_solve = 150'000;
+  int num_sampled = 0;
+  for (int i = 0; i < num_to_solve; ++i) {
+    auto problem = reader_.getNextProblem();
+    if (!problem) {
+      break;
+    }
+    const std::size_t num_rows =
+        problem->equality_rows.size() + problem->inequality_rows.size();
+    if (i % core::kPolicySampleStride != 0 || num_rows <= 1) {
+      continue;
+    }
+
+    // every candidate solves its own copy, copied outside the timing
+    for (std::size_t c = 0; c < pipelines.size(); ++c) {
+      setPipelineProblem(core::InputRows(*problem), pipeline_problem);
+      const auto start = std::chrono::steady_clock::now();
+      solve_statuses.at(c) = pipelines.at(c).solveProblem(pipeline_problem);
+      times_nanos.at(c) = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+    }
+    tuner.addSample(solvers::pipeline::SelectionPolicy::getBucket(
+                        solvers::pipeline::SelectionPolicy::getFeatures(
+                            *problem)),
+                    times_nanos, solve_statuses);
+    ++num_sampled;
+  }
+
+  tuner.writeReport(std::cout);
+  std::cout << "Sampled problems: " << num_sampled << std::endl;
+  std::ofstream policy_file(policy_path);
+  if (!policy_file.is_open()) {
+    std::cout << "Could not open " << policy_path << std::endl;
+    return;
+  }
+  tuner.getPolicy().writeTable(policy_file);
+  std::cout << "Policy written to " << policy_path << std::endl;
+}
+
+void CombinedRun::runStream(std::istream &problem_stream,
+                            std::ostream &result_stream) {
+  utils::ModifiedPrimalReader reader_(problem_stream);
+  pipelines_.clear();
+  num_policy_picks_.clear();
+
+  for (std::uint64_t index = 0;; ++index) {
+    auto problem = reader_.getNextProblem();
+    if (!problem) {
+      break;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const core::SolveStatus solve_state = solveProblem(std::move(*problem));
+    const std::uint64_t time_nanos =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+
+    writeResult(result_stream, index, solve_state, time_nanos);
+    // flushed so that each result is seen as soon as it is solved
+    result_stream.flush();
+  }
+}
+
+core::SolveStatus CombinedRun::solveProblem(core::InputRows &&problem) {
+  // problems without rows or with a single one are feasible, as in
+  // runSolver(), and are answered without a solution
+  pipeline_problem_.variable_values.clear();
+  if (problem.equality_rows.size() + problem.inequality_rows.size() <= 1) {
+    return core::SolveStatus::kFeasible;
+  }
+  solvers::pipeline::SolverPipeline *pipeline = selectPipeline(problem);
+  if (pipeline == nullptr) {
+    return core::SolveStatus::kError;
+  }
+  return solvePipeline(std::move(problem), *pipeline, pipeline_problem_);
+}
+
+void CombinedRun::writeResult(std::ostream &result_stream,
+                              const std::uint64_t index,
+                              const core::SolveStatus solve_status,
+                              const std::uint64_t time_nanos) const {
+  result_stream << index << " " << utils::getSolveStatusName(solve_status) << " "
+                << time_nanos;
+  if (is_stream_solution_enabled_ &&
+      solve_status == core::SolveStatus::kFeasible) {
+    result_stream.precision(std::numeric_limits<double>::max_digits10);
+    for (const double value : pipeline_problem_.variable_values) {
+      result_stream << " " << value;
+    }
+  }
+  result_stream << "\n";
+}
+
+void CombinedRun::copySettings(const CombinedRun &settings) {
+  pricing_strategy_ = settings.pricing_strategy_;
+  is_perturbation_enabled_ = settings.is_perturbation_enabled_;
+  pipeline_ = settings.pipeline_;
+  is_policy_set_ = settings.is_policy_set_;
+  policy_ = settings.policy_;
+  is_stream_solution_enabled_ = settings.is_stream_solution_enabled_;
+  pipelines_.clear();
+}
+
 void CombinedRun::runSolver(const std::string problems_filepath) {
 
   const std::string pp = problems_filepath;
@@ -8,17 +419,43 @@ void CombinedRun::runSolver(const std::string problems_filepath) {
 
   // instantiate everything
   utils::ModifiedPrimalReader reader_(filestream);
+  solvers::bounded_dual::BoundedDualSimplex dual_solver_;
+  solvers::bounded_dual::TinyDualSimplexDispatcher tiny_dual_solver_;
+  solvers::fourier_motzkin::FourierMotzkin elimination_solver_;
+  solvers::interior_point::InteriorPoint interior_point_solver_;
+  solvers::pdhg::PrimalDualHybridGradient pdhg_solver_;
   solvers::bland_simplex::BlandPrimalSimplex simplex_solver_;
-  utils::PrimalReformatter prf_;
-  utils::LogicalReformatter lrf_;
+  solvers::branch_and_bound::BranchAndBound integer_solver_;
+  utils::FusedReformatter rf_;
+  simplex_solver_.setPricingStrategy(pricing_strategy_);
+  simplex_solver_.setPerturbation(is_perturbation_enabled_);
+  dual_solver_.setPerturbation(is_perturbation_enabled_);
+  tiny_dual_solver_.setPerturbation(is_perturbation_enabled_);
+  total_stats_ = core::SimplexStats();
+  num_perturbed_ = 0;
+  total_presolve_stats_ = core::PresolveStats();
+  num_presolved_ = 0;
+  num_nodes_ = 0;
+  num_interior_point_solves_ = 0;
+  num_interior_point_iterations_ = 0;
+  num_pdhg_solves_ = 0;
+  num_pdhg_iterations_ = 0;
+  num_sucessfully_solved_ = 0;
+  num_infeasible_ = 0;
+  num_error_ = 0;
+  num_didnt_converge_ = 0;
+
+  pipelines_.clear();
+  num_policy_picks_.clear();
+  core::PipelineProblem pipeline_problem;
+  if (!results_path_.empty() && !results_writer_.open(results_path_)) {
+    std::cout << "Could not open " << results_path_ << std::endl;
+  }
 
   // report variables
   int num_to_solve = 150'000;
+  int num_attempted = 0;
   int num_empty = 0;
-  int num_sucessfully_solved = 0;
-  int num_infeasible = 0;
-  int num_error = 0;
-  int num_didnt_converge = 0;
 
   // to be reused
   int num_equality_constraints;
@@ -32,20 +469,71 @@ void CombinedRun::runSolver(const std::string problems_filepath) {
 
   for (std::size_t i = 0; i < num_to_solve; ++i) {
     auto problem = reader_.getNextProblem();
+    if (!problem) {
+      break;
+    }
+    ++num_attempted;
+    if (results_writer_.isOpen()) {
+      result_index_ = i;
+      result_iterations_ = 0;
+      result_start_ = std::chrono::steady_clock::now();
+    }
     if (problem->equality_rows.size() == 0 &&
         problem->inequality_rows.size() == 0) {
       ++num_empty;
+      writeProblemResult(core::SolveStatus::kFeasible, "empty", {});
+    } else if (is_integer_mode_) {
+      rf_.reformatProblem(problem.value());
+      integer_solver_.setProblem(
+          rf_.getLogicalProblem(),
+          static_cast<int>(problem->inequality_rows.size()),
+          static_cast<int>(problem->equality_rows.size()));
+      const core::SolveStatus solve_state = integer_solver_.solveProblem();
+      addStats(integer_solver_.getStats());
+      num_nodes_ += integer_solver_.getNodeCount();
+      countSolveStatus(solve_state);
+      if (results_writer_.isOpen()) {
+        std::vector<double> variable_values;
+        if (solve_state == core::SolveStatus::kFeasible) {
+          const std::vector<int> integer_solution =
+              integer_solver_.getSolution();
+          variable_values.assign(integer_solution.begin(),
+                                 integer_solution.end());
+        }
+        writeProblemResult(solve_state, "branch_and_bound", variable_values);
+      }
     } else if (problem->equality_rows.size() == 0 &&
                problem->inequality_rows.size() == 1) {
-      ++num_sucessfully_solved;
+      ++num_sucessfully_solved_;
+      writeProblemResult(core::SolveStatus::kFeasible, "trivial", {});
     } else if (problem->equality_rows.size() == 1 &&
                problem->inequality_rows.size() == 0) {
-      ++num_sucessfully_solved;
+      ++num_sucessfully_solved_;
+      writeProblemResult(core::SolveStatus::kFeasible, "trivial", {});
+    } else if (!pipeline_.empty() || is_policy_set_) {
+      // the pipeline set or picked by the policy replaces the chain below
+      solvers::pipeline::SolverPipeline *pipeline = selectPipeline(*problem);
+      if (pipeline == nullptr) {
+        countSolveStatus(core::SolveStatus::kError);
+        writeProblemResult(core::SolveStatus::kError, "pipeline", {});
+      } else {
+        solvePipeline(std::move(*problem), *pipeline, pipeline_problem);
+      }
+    } else if (is_pdhg_enabled_ &&
+               problem->num_variables - 1 >= core::kPdhgMinVariables &&
+               solvePdhg(problem.value(), pdhg_solver_)) {
+      // very large problem PDHG gave a verdict on
+    } else if (is_interior_point_enabled_ &&
+               problem->num_variables - 1 >=
+                   core::kInteriorPointMinVariables &&
+               solveInteriorPoint(problem.value(), interior_point_solver_)) {
+      // large problem the interior point method gave a verdict on
     } else {
 
-      // Try presolve
-      core::FormattedLogicalProblem logical_problem =
-          lrf_.reformatProblem(problem.value());
+      // Try presolve, primal table is only built if presolve fails
+      rf_.reformatProblem(problem.value());
+      const core::FormattedLogicalProblem &logical_problem =
+          rf_.getLogicalProblem();
 
       num_inequality_constraints =
           static_cast<int>(problem->inequality_rows.size());
@@ -58,41 +546,73 @@ void CombinedRun::runSolver(const std::string problems_filepath) {
           num_equality_constraints, false);
 
       presolve.applyPresolve();
-      presolve.applyPostsolve();
-      if (presolve.infeasible_) {
-        ++num_infeasible;
-      } else if (presolve.reduced_to_empty_) {
-        ++num_sucessfully_solved;
+      if (presolve.reduced_to_empty_) {
+        presolve.applyPostsolve();
+      }
+      ++num_presolved_;
+      if (presolve.infeasible_ || (presolve.reduced_to_empty_ &&
+                                   !presolve.unsatisfied_constraints_)) {
+        const core::SolveStatus solve_state =
+            presolve.infeasible_ ? core::SolveStatus::kInfeasible
+                                 : core::SolveStatus::kFeasible;
+        countSolveStatus(solve_state);
+        utils::addPresolveStats(total_presolve_stats_, presolve.getStats());
+        if (results_writer_.isOpen()) {
+          writeProblemResult(solve_state, "presolve",
+                             presolve.infeasible_
+                                 ? std::vector<double>()
+                                 : presolve.getFeasibleSolution());
+        }
       } else {
-        // try simplex solver
-
-        core::FormattedPrimalProblem rf_prob =
-            prf_.reformatProblem(problem.value());
-        simplex_solver_.setProblem(rf_prob.problem_matrix);
-        simplex_solver_.setBasis(rf_prob.basic_variables);
-        auto solve_state = simplex_solver_.solveProblem(false, *problem);
-
-        switch (solve_state) {
-        case core::SolveStatus::kDidntConverge:
-          ++num_didnt_converge;
-          break;
-
-        case core::SolveStatus::kFeasible:
-          ++num_sucessfully_solved;
-          break;
-
-        case core::SolveStatus::kInfeasible:
-          ++num_infeasible;
-          break;
-
-        default:
-          ++num_error;
-          break;
+        // try bounded dual simplex on what presolve left, then bland's rule
+        // on the full problem if it gives no verdict
+        const bool is_reduced =
+            !presolve.reduced_to_empty_ && !presolve.overflow_;
+        core::FormattedBoundedProblem reduced_problem;
+        if (is_reduced) {
+          reduced_problem = presolve.getReducedProblem().problem;
+        }
+        const core::FormattedBoundedProblem &bounded_problem =
+            is_reduced ? reduced_problem : rf_.getBoundedProblem();
+
+        // exact elimination first if enabled, the simplex takes the problems
+        // it gives up on
+        core::SolveStatus elimination_state =
+            core::SolveStatus::kDidntConverge;
+        if (is_fourier_motzkin_enabled_ &&
+            bounded_problem.column_lower_bounds.size() <=
+                core::kFourierMotzkinMaxColumns) {
+          elimination_solver_.setProblem(bounded_problem);
+          elimination_state = elimination_solver_.solveProblem();
+        }
+
+        // problems of a few rows and columns have a fixed size solver
+        if (elimination_state == core::SolveStatus::kFeasible ||
+            elimination_state == core::SolveStatus::kInfeasible) {
+          finishReducedSolve(*problem, presolve, is_reduced, elimination_state,
+                             elimination_solver_.getSolution(),
+                             "fourier_motzkin", simplex_solver_, rf_);
+        } else if (tiny_dual_solver_.isSupported(bounded_problem)) {
+          const core::SolveStatus solve_state =
+              tiny_dual_solver_.solveProblem(bounded_problem);
+          addStats(tiny_dual_solver_.getStats());
+          finishReducedSolve(*problem, presolve, is_reduced, solve_state,
+                          tiny_dual_solver_.getSolution(), "tiny",
+                          simplex_solver_, rf_);
+        } else {
+          dual_solver_.setProblem(bounded_problem);
+          const core::SolveStatus solve_state = dual_solver_.solveProblem();
+          addStats(dual_solver_.getStats());
+          finishReducedSolve(*problem, presolve, is_reduced, solve_state,
+                          dual_solver_.getSolution(), "dual", simplex_solver_,
+                          rf_);
         }
       }
     }
   }
 
+  results_writer_.close();
+
   std::uint64_t end_time =
       std::chrono::duration_cast<std::chrono::nanoseconds>(
           std::chrono::high_resolution_clock::now().time_since_epoch())
@@ -104,11 +624,52 @@ void CombinedRun::runSolver(const std::string problems_filepath) {
 
   // report results
   std::cout << "Results: " << std::endl;
-  std::cout << "Number of probelms attempted: " << num_to_solve << std::endl;
+  std::cout << "Number of probelms attempted: " << num_attempted << std::endl;
   std::cout << "Time taken: " << time_taken_secs << " seconds" << std::endl;
-  std::cout << "Number feasible: " << num_sucessfully_solved << std::endl;
-  std::cout << "Number infeasible: " << num_infeasible << std::endl;
+  std::cout << "Number feasible: " << num_sucessfully_solved_ << std::endl;
+  std::cout << "Number infeasible: " << num_infeasible_ << std::endl;
   std::cout << "Number of empty propblems: " << num_empty << std::endl;
-  std::cout << "Number didn't converge: " << num_didnt_converge << std::endl;
-  std::cout << "Number of errors: " << num_error << std::endl;
+  std::cout << "Number didn't converge: " << num_didnt_converge_
+            << std::endl;
+  std::cout << "Number of errors: " << num_error_ << std::endl;
+  std::cout << "Simplex iterations: " << total_stats_.num_iterations
+            << std::endl;
+  std::cout << "Degenerate iterations: "
+            << total_stats_.num_degenerate_iterations << std::endl;
+  std::cout << "Repeated bases: " << total_stats_.num_repeated_bases
+            << std::endl;
+  std::cout << "Perturbed solves: " << num_perturbed_ << std::endl;
+  if (is_integer_mode_) {
+    std::cout << "Branch and bound nodes: " << num_nodes_ << std::endl;
+  }
+  if (is_interior_point_enabled_ || num_interior_point_solves_ > 0) {
+    std::cout << "Interior point solves: " << num_interior_point_solves_
+              << std::endl;
+    std::cout << "Interior point iterations: "
+              << num_interior_point_iterations_ << std::endl;
+  }
+  if (num_pdhg_solves_ > 0) {
+    std::cout << "PDHG solves: " << num_pdhg_solves_ << std::endl;
+    std::cout << "PDHG iterations: " << num_pdhg_iterations_ << std::endl;
+  }
+  for (const auto &pipeline_and_picks : num_policy_picks_) {
+    std::cout << "Policy picked " << pipeline_and_picks.first << ": "
+              << pipeline_and_picks.second << std::endl;
+  }
+
+  const core::PresolveStats &presolve_stats = total_presolve_stats_;
+  std::uint64_t presolve_time_nanos =
+      presolve_stats.row_rules_time_nanos +
+      presolve_stats.activity_rules_time_nanos +
+      presolve_stats.col_rules_time_nanos +
+      presolve_stats.parallel_col_rules_time_nanos +
+      presolve_stats.doubleton_rules_time_nanos;
+  std::cout << "Presolve time: "
+            << static_cast<double>(presolve_time_nanos) / 1'000'000'000
+            << " seconds" << std::endl;
+  std::cout << "Postsolve time: "
+            << static_cast<double>(presolve_stats.postsolve_time_nanos) /
+                   1'000'000'000
+            << " seconds" << std::endl;
+  writePresolveStats();
 }
\ No newline at end of file
@@ -1,21 +1,366 @@
+#pragma once
+
 #include "../lib/core/consts.hpp"
 #include "../lib/core/types.hpp"
+#include "../lib/solvers/bounded_dual/bounded_dual_simplex.hpp"
+#include "../lib/solvers/bounded_dual/tiny_dual_simplex_dispatcher.hpp"
+#include "../lib/solvers/branch_and_bound/branch_and_bound.hpp"
+#include "../lib/solvers/fourier_motzkin/fourier_motzkin.hpp"
+#include "../lib/solvers/interior_point/interior_point.hpp"
 #include "../lib/solvers/logical_solver/presolve.hpp"
+#include "../lib/solvers/pdhg/pdhg.hpp"
+#include "../lib/solvers/pipeline/policy_tuner.hpp"
+#include "../lib/solvers/pipeline/selection_policy.hpp"
+#include "../lib/solvers/pipeline/solver_registry.hpp"
 #include "../lib/solvers/primal_bland/bland_simplex.hpp"
-#include "../lib/utils/logical_reformatter.hpp"
-#include "../lib/utils/primal_reformatter.hpp"
+#include "../lib/utils/fused_reformatter.hpp"
 #include "../lib/utils/reader.hpp"
+#include "../lib/utils/results_writer.hpp"
+#include "../lib/utils/stats_writer.hpp"
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 class CombinedRun {
 public:
-  // empty constructor
-  CombinedRun() {}
+  CombinedRun()
+      : pricing_strategy_(core::PricingStrategy::kDantzig),
+        is_perturbation_enabled_(false), total_stats_(), num_perturbed_(0),
+        total_presolve_stats_(), num_presolved_(0), is_integer_mode_(false),
+        num_nodes_(0),
+        is_fourier_motzkin_enabled_(false), is_interior_point_enabled_(false),
+        num_interior_point_solves_(0), num_interior_point_iterations_(0),
+        is_pdhg_enabled_(true), num_pdhg_solves_(0), num_pdhg_iterations_(0),
+        is_policy_set_(false), is_stream_solution_enabled_(false),
+        result_index_(0), result_iterations_(0),
+        num_sucessfully_solved_(0),
+        num_infeasible_(0), num_error_(0), num_didnt_converge_(0) {}
 
   void runSolver(const std::string problems_filepath);
+
+  /**
+   * @brief Solve problems as they arrive on a stream until it ends, writing
+   * one line per problem as soon as it is solved: its index from 0, its
+   * verdict (feasible, infeasible, didnt_converge or error), the solve time
+   * in nanoseconds and, if enabled, the values of its variables. Problems go
+   * through the pipeline set, the one the policy picks, or the default one.
+   * Integer mode is not used
+   *
+   * @param problem_stream problems in the format of the problem files
+   * @param result_stream
+   */
+  void runStream(std::istream &problem_stream, std::ostream &result_stream);
+
+  /**
+   * @brief Solve one problem the way runStream() does. Pipelines are built on
+   * first use and kept, as is the pipeline problem, so that later problems
+   * reuse their storage
+   *
+   * @param problem
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solveProblem(core::InputRows &&problem);
+
+  /**
+   * @brief Write the result line of runStream() for the last problem given
+   * to solveProblem(), without flushing
+   *
+   * @param result_stream
+   * @param index
+   * @param solve_status
+   * @param time_nanos
+   */
+  void writeResult(std::ostream &result_stream, const std::uint64_t index,
+                   const core::SolveStatus solve_status,
+                   const std::uint64_t time_nanos) const;
+
+  /**
+   * @brief Take the simplex options, pipeline, policy and result settings of
+   * another run, so that several runs can solve problems alike. Counters and
+   * built pipelines are not copied
+   *
+   * @param settings
+   */
+  void copySettings(const CombinedRun &settings);
+
+  /**
+   * @brief Append the values of the variables to the result lines of
+   * feasible problems in runStream(), when the solvers that decided them
+   * recover a solution
+   *
+   * @param is_stream_solution_enabled
+   */
+  void setStreamSolution(const bool is_stream_solution_enabled);
+
+  /**
+   * @brief Run every candidate pipeline of PolicyTuner on one problem in
+   * kPolicySampleStride and write the policy picking the fastest one per
+   * bucket of features, for setPolicyPath()
+   *
+   * @param problems_filepath
+   * @param policy_path
+   */
+  void tunePolicy(const std::string problems_filepath,
+                  const std::string policy_path);
+
+  /**
+   * @brief Write the index, verdict, solver giving it, iterations, solve time
+   * and values of the variables of every problem of runSolver() to a file,
+   * as CSV, JSONL or binary by its extension (.csv, .jsonl, .bin). Results
+   * are written by a thread of their own. Iterations are summed over every
+   * simplex, interior point and PDHG solve made on the problem
+   *
+   * @param results_path
+   * @return bool whether the extension is one of a known format
+   */
+  bool setResultsPath(const std::string &results_path);
+
+  /**
+   * @brief Set the pricing strategy used by the primal simplex fallback
+   *
+   * @param pricing_strategy
+   */
+  void setPricingStrategy(const core::PricingStrategy pricing_strategy);
+
+  /**
+   * @brief Enable perturbation in both simplex solvers. Without it, a primal
+   * simplex solve that does not converge is retried once with perturbation
+   *
+   * @param is_perturbation_enabled
+   */
+  void setPerturbation(const bool is_perturbation_enabled);
+
+  /**
+   * @brief Write presolve rule counts and timings summed over the run to a
+   * JSON file once the run finishes. Nothing is written if the path is empty
+   *
+   * @param presolve_stats_path
+   */
+  void setPresolveStatsPath(const std::string presolve_stats_path);
+
+  /**
+   * @brief Look for integer solutions instead of real ones. Every problem is
+   * then solved by branch and bound, including single row ones which are no
+   * longer trivially feasible
+   *
+   * @param is_integer_mode
+   */
+  void setIntegerMode(const bool is_integer_mode);
+
+  /**
+   * @brief Try Fourier-Motzkin elimination on what presolve leaves when it
+   * has at most kFourierMotzkinMaxColumns columns, before any simplex. Its
+   * verdicts are exact, the simplex takes the problems it gives up on
+   *
+   * @param is_fourier_motzkin_enabled
+   */
+  void setFourierMotzkin(const bool is_fourier_motzkin_enabled);
+
+  /**
+   * @brief Send problems with at least kInteriorPointMinVariables variables to
+   * the interior point method before presolve. The usual path takes those it
+   * gives no verdict on
+   *
+   * @param is_interior_point_enabled
+   */
+  void setInteriorPoint(const bool is_interior_point_enabled);
+
+  /**
+   * @brief Send problems with at least kPdhgMinVariables variables to the
+   * first order PDHG solver before presolve, ahead of the interior point
+   * method. The usual path takes those it gives no verdict on. Enabled by
+   * default, the simplex path takes minutes on problems of that size
+   *
+   * @param is_pdhg_enabled
+   */
+  void setPdhg(const bool is_pdhg_enabled);
+
+  /**
+   * @brief Solve every problem that is not trivial with a pipeline of
+   * registered solvers instead of the built in chain, e.g.
+   * "presolve,tiny,dual,primal", which makes the same choices as the chain
+   * without the optional solvers. The Fourier-Motzkin, interior point and
+   * PDHG options are then ignored, integer mode is not
+   *
+   * @param pipeline comma separated solver names
+   * @return bool whether every name is registered
+   */
+  bool setPipeline(const std::string &pipeline);
+
+  /**
+   * @brief returns the names pipelines can be built from
+   *
+   * @return std::vector<std::string>
+   */
+  std::vector<std::string> getSolverNames() const;
+
+  /**
+   * @brief Route every problem that is not trivial through the pipeline a
+   * policy written by tunePolicy() picks from its features. A pipeline set
+   * with setPipeline() takes precedence
+   *
+   * @param policy_path
+   * @return bool whether the policy was read and its pipelines are valid
+   */
+  bool setPolicyPath(const std::string &policy_path);
+
+private:
+  core::PricingStrategy pricing_strategy_;
+  bool is_perturbation_enabled_;
+
+  // simplex counters summed over every problem of the run
+  core::SimplexStats total_stats_;
+  int num_perturbed_;
+
+  // presolve counters summed over every presolved problem of the run
+  core::PresolveStats total_presolve_stats_;
+  int num_presolved_;
+  std::string presolve_stats_path_;
+
+  // branch and bound nodes summed over every problem of an integer run
+  bool is_integer_mode_;
+  long long num_nodes_;
+
+  bool is_fourier_motzkin_enabled_;
+
+  bool is_interior_point_enabled_;
+  int num_interior_point_solves_;
+  long long num_interior_point_iterations_;
+
+  bool is_pdhg_enabled_;
+  int num_pdhg_solves_;
+  long long num_pdhg_iterations_;
+
+  solvers::pipeline::SolverRegistry solver_registry_;
+  std::string pipeline_;
+
+  bool is_policy_set_;
+  solvers::pipeline::SelectionPolicy policy_;
+
+  // pipelines built so far by name, and how often the policy picked each
+  std::map<std::string, solvers::pipeline::SolverPipeline> pipelines_;
+  std::map<std::string, int> num_policy_picks_;
+
+  bool is_stream_solution_enabled_;
+
+  // results file of runSolver(), with the index, start and simplex
+  // iterations of the problem being solved
+  std::string results_path_;
+  utils::ResultsWriter results_writer_;
+  std::uint64_t result_index_;
+  std::chrono::steady_clock::time_point result_start_;
+  long long result_iterations_;
+
+  // problem given to solveProblem(), reused between problems
+  core::PipelineProblem pipeline_problem_;
+
+  // verdicts of the run, counted by the helpers that finish a solve
+  int num_sucessfully_solved_;
+  int num_infeasible_;
+  int num_error_;
+  int num_didnt_converge_;
+
+  void addStats(const core::SimplexStats &stats);
+
+  void countSolveStatus(const core::SolveStatus solve_status);
+
+  /**
+   * @brief Hand the result of the problem being solved to the results
+   * writer, timed from result_start_, if a results file is open
+   *
+   * @param solve_status
+   * @param engine name of the solver that gave the verdict
+   * @param solution values of the variables, empty if not recovered
+   */
+  void writeProblemResult(const core::SolveStatus solve_status,
+                          const std::string &engine,
+                          const std::vector<double> &solution);
+
+  /**
+   * @brief Solve a problem with the interior point method, counting its
+   * verdict if it gives one
+   *
+   * @param problem
+   * @param interior_point_solver
+   * @return bool whether there was a verdict
+   */
+  bool solveInteriorPoint(
+      const core::InputRows &problem,
+      solvers::interior_point::InteriorPoint &interior_point_solver);
+
+  /**
+   * @brief Solve a problem with PDHG, counting its verdict if it gives one
+   *
+   * @param problem
+   * @param pdhg_solver
+   * @return bool whether there was a verdict
+   */
+  bool solvePdhg(const core::InputRows &problem,
+                 solvers::pdhg::PrimalDualHybridGradient &pdhg_solver);
+
+  /**
+   * @brief start a pipeline problem from rows, clearing what the stages left
+   * on the last one
+   *
+   * @param problem
+   * @param pipeline_problem
+   */
+  void setPipelineProblem(core::InputRows &&problem,
+                          core::PipelineProblem &pipeline_problem);
+
+  /**
+   * @brief Solve a problem with the pipeline, counting its verdict and the
+   * simplex and presolve counters of its stages
+   *
+   * @param problem
+   * @param pipeline
+   * @param pipeline_problem reused between problems
+   * @return core::SolveStatus
+   */
+  core::SolveStatus solvePipeline(core::InputRows &&problem,
+                                  solvers::pipeline::SolverPipeline &pipeline,
+                                  core::PipelineProblem &pipeline_problem);
+
+  /**
+   * @brief returns the pipeline set with setPipeline(), else the one the
+   * policy picks for the problem, else the default one, built on first use.
+   * Returns nullptr, printing an error, if it cannot be built
+   *
+   * @param problem
+   * @return solvers::pipeline::SolverPipeline*
+   */
+  solvers::pipeline::SolverPipeline *
+  selectPipeline(const core::InputRows &problem);
+
+  /**
+   * @brief Postsolve the solution found for a reduced problem, retry a
+   * problem without a verdict with the primal simplex on the full table if it
+   * has at most kPrimalFallbackMaxVariables variables, and count the verdict
+   *
+   * @param problem
+   * @param presolve
+   * @param is_reduced whether the reduced problem was solved
+   * @param solve_state verdict on the reduced problem
+   * @param solution solution of the reduced problem
+   * @param engine name of the solver of the reduced problem, for results
+   * @param simplex_solver
+   * @param rf holding the rows of problem, scanned before presolve
+   */
+  void finishReducedSolve(const core::InputRows &problem,
+                       logical_solver::Presolve &presolve,
+                       const bool is_reduced, core::SolveStatus solve_state,
+                       const std::vector<double> &solution,
+                       const char *engine,
+                       solvers::bland_simplex::BlandPrimalSimplex &simplex_solver,
+                       utils::FusedReformatter &rf);
+
+  void writePresolveStats();
 };
\ No newline at end of file
@@ -1,7 +1,115 @@
 #include "main.hpp"
 #include <string>
+#include <thread>
 
-int main() {
+int main(int argc, char *argv[]) {
+
+  CombinedRun run_;
+  std::string tuning_path;
+  bool is_streaming = false;
+  std::string stream_path;
+  std::string socket_path;
+  // optional arguments: --integer to look for integer solutions,
+  // --fourier-motzkin to try exact elimination before the simplex,
+  // --interior-point to send large problems to the interior point method,
+  // --pdhg or --no-pdhg to send very large ones to the first order solver or
+  // not, by default they are, --pipeline=<names> to solve with a comma
+  // separated list of solvers instead, --policy=<file> to pick the list per
+  // problem from a policy written by --tune=<file>, which tunes one instead of
+  // solving, --stream or --stream=<file> to solve problems from stdin or a file
+  // such as a named pipe as they arrive, --serve=<socket> to solve problems
+  // sent by run_client over a Unix domain socket, --solution to print the
+  // values of the variables of feasible ones, --results=<file> to write every
+  // problem's verdict, solver, iterations, time and solution to a .csv, .jsonl
+  // or .bin file, and --presolve-stats=<file> to write presolve stats to as
+  // JSON. Anything else prints the usage
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument = argv[i];
+    if (argument == "--integer") {
+      run_.setIntegerMode(true);
+    } else if (argument == "--fourier-motzkin") {
+      run_.setFourierMotzkin(true);
+    } else if (argument == "--interior-point") {
+      run_.setInteriorPoint(true);
+    } else if (argument == "--pdhg") {
+      run_.setPdhg(true);
+    } else if (argument == "--no-pdhg") {
+      run_.setPdhg(false);
+    } else if (argument.rfind("--pipeline=", 0) == 0) {
+      const std::string pipeline =
+          argument.substr(std::string("--pipeline=").size());
+      if (!run_.setPipeline(pipeline)) {
+        std::cerr << "Unknown solver in pipeline " << pipeline
+                  << ", solvers are:";
+        for (const std::string &name : run_.getSolverNames()) {
+          std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+        return 1;
+      }
+    } else if (argument.rfind("--policy=", 0) == 0) {
+      const std::string policy_path =
+          argument.substr(std::string("--policy=").size());
+      if (!run_.setPolicyPath(policy_path)) {
+        std::cerr << "Could not read policy " << policy_path << std::endl;
+        return 1;
+      }
+    } else if (argument.rfind("--tune=", 0) == 0) {
+      tuning_path = argument.substr(std::string("--tune=").size());
+    } else if (argument == "--stream") {
+      is_streaming = true;
+    } else if (argument.rfind("--stream=", 0) == 0) {
+      is_streaming = true;
+      stream_path = argument.substr(std::string("--stream=").size());
+    } else if (argument.rfind("--serve=", 0) == 0) {
+      socket_path = argument.substr(std::string("--serve=").size());
+    } else if (argument.rfind("--results=", 0) == 0) {
+      const std::string results_path =
+          argument.substr(std::string("--results=").size());
+      if (!run_.setResultsPath(results_path)) {
+        std::cerr << "Results file " << results_path
+                  << " must end in .csv, .jsonl or .bin" << std::endl;
+        return 1;
+      }
+    } else if (argument == "--solution") {
+      run_.setStreamSolution(true);
+    } else if (argument.rfind("--presolve-stats=", 0) == 0) {
+      run_.setPresolveStatsPath(
+          argument.substr(std::string("--presolve-stats=").size()));
+    } else {
+      std::cerr << "Unknown argument " << argument << std::endl;
+      std::cerr << "Usage: run_main [--integer] [--fourier-motzkin] "
+                   "[--interior-point] [--pdhg] [--no-pdhg] "
+                   "[--pipeline=<names>] [--policy=<file>] [--tune=<file>] "
+                   "[--stream[=<file>]] [--serve=<socket>] [--solution] "
+                   "[--results=<file>] [--presolve-stats=<file>]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // streams are read without asking for a file, and only results are
+  // written to stdout
+  if (is_streaming) {
+    if (stream_path.empty()) {
+      run_.runStream(std::cin, std::cout);
+    } else {
+      std::ifstream stream_file(stream_path);
+      if (!stream_file.is_open()) {
+        std::cerr << "Could not open " << stream_path << std::endl;
+        return 1;
+      }
+      run_.runStream(stream_file, std::cout);
+    }
+    return 0;
+  }
+
+  if (!socket_path.empty()) {
+    SolveServer server(run_,
+                       static_cast<int>(std::thread::hardware_concurrency()));
+    // a server that could not listen is reported to whatever started it
+    return server.run(socket_path) ? 0 : 1;
+  }
 
   const std::string user = "other";
 
@@ -24,8 +132,11 @@ int main() {
     return 0;
   }
 
-  CombinedRun run_;
-  run_.runSolver(problem_path);
+  if (tuning_path.empty()) {
+    run_.runSolver(problem_path);
+  } else {
+    run_.tunePolicy(problem_path, tuning_path);
+  }
 
   // DualRun run_;
   // run_.runDualSolver(problem_path);
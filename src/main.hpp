@@ -1,3 +1,4 @@
 #include "combined_solver.hpp"
+#include "solve_server.hpp"
 // #include "logical_solver_run.hpp"
 //#include "dual_run.hpp"
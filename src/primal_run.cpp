@@ -21,6 +21,11 @@ void PrimalRun::printProblem(const core::InputRows input_rows) {
   std::cout << std::endl;
 }
 
+void PrimalRun::setPricingStrategy(
+    const core::PricingStrategy pricing_strategy) {
+  pricing_strategy_ = pricing_strategy;
+}
+
 void PrimalRun::runPrimalSolver(const std::string problems_filepath) {
 
   std::fstream filestream;
@@ -31,6 +36,7 @@ void PrimalRun::runPrimalSolver(const std::string problems_filepath) {
   // solvers::revised_primal_simplex::RevisedPrimalSimplex solver_;
   solvers::bland_simplex::BlandPrimalSimplex solver_;
   utils::PrimalReformatter rf_;
+  solver_.setPricingStrategy(pricing_strategy_);
 
   // problem 2019 is first basis fault!
   int num_to_solve = 150'000;
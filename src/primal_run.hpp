@@ -12,9 +12,18 @@
 
 class PrimalRun {
 public:
-  // empty constructor
-  PrimalRun() {}
+  PrimalRun() : pricing_strategy_(core::PricingStrategy::kBland) {}
 
   void runPrimalSolver(const std::string problems_filepath);
   void printProblem(const core::InputRows input_rows);
+
+  /**
+   * @brief Set the pricing strategy used by the primal simplex
+   *
+   * @param pricing_strategy
+   */
+  void setPricingStrategy(const core::PricingStrategy pricing_strategy);
+
+private:
+  core::PricingStrategy pricing_strategy_;
 };
\ No newline at end of file
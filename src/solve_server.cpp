@@ -0,0 +1,235 @@
+#include "solve_server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+SolveServer::SocketBuffer::SocketBuffer(const int fd) : fd_(fd) {
+  setg(buffer_, buffer_, buffer_);
+}
+
+SolveServer::SocketBuffer::int_type SolveServer::SocketBuffer::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  const ssize_t num_read = ::read(fd_, buffer_, sizeof(buffer_));
+  if (num_read <= 0) {
+    return traits_type::eof();
+  }
+  setg(buffer_, buffer_, buffer_ + num_read);
+  return traits_type::to_int_type(*gptr());
+}
+
+SolveServer::SolveServer(const CombinedRun &settings, const int num_workers)
+    : is_stopping_(false), num_readers_(0) {
+  const int worker_count =
+      std::max(1, std::min(num_workers, core::kServerMaxWorkers));
+  for (int i = 0; i < worker_count; ++i) {
+    worker_runs_.push_back(std::make_unique<CombinedRun>());
+    worker_runs_.back()->copySettings(settings);
+  }
+}
+
+bool SolveServer::run(const std::string &socket_path) {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Socket path " << socket_path << " is too long" << std::endl;
+    return false;
+  }
+  std::strcpy(address.sun_path, socket_path.c_str());
+
+  const int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    std::cerr << "Could not create socket: " << std::strerror(errno)
+              << std::endl;
+    return false;
+  }
+  ::unlink(socket_path.c_str());
+  if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0 ||
+      ::listen(listen_fd, SOMAXCONN) < 0) {
+    std::cerr << "Could not listen on " << socket_path << ": "
+              << std::strerror(errno) << std::endl;
+    ::close(listen_fd);
+    return false;
+  }
+  std::cerr << "Serving on " << socket_path << " with " << worker_runs_.size()
+            << " workers" << std::endl;
+
+  for (std::unique_ptr<CombinedRun> &worker_run : worker_runs_) {
+    workers_.emplace_back(&SolveServer::runWorker, this,
+                          std::ref(*worker_run));
+  }
+
+  for (;;) {
+    const int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "Could not accept: " << std::strerror(errno) << std::endl;
+      break;
+    }
+    auto connection = std::make_shared<Connection>();
+    connection->fd = fd;
+    connection->num_submitted = 0;
+    connection->num_answered = 0;
+    connection->is_reading_done = false;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      ++num_readers_;
+    }
+    std::thread(&SolveServer::readConnection, this, std::move(connection))
+        .detach();
+  }
+
+  // let the open connections finish before stopping the workers
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_condition_.wait(lock, [this] { return num_readers_ == 0; });
+    is_stopping_ = true;
+  }
+  queue_condition_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+  ::close(listen_fd);
+  ::unlink(socket_path.c_str());
+  return true;
+}
+
+void SolveServer::readConnection(std::shared_ptr<Connection> connection) {
+  SocketBuffer buffer(connection->fd);
+  std::istream problem_stream(&buffer);
+  utils::ModifiedPrimalReader reader(problem_stream);
+
+  for (std::uint64_t index = 0;; ++index) {
+    auto problem = reader.getNextProblem();
+    if (!problem) {
+      break;
+    }
+    {
+      std::lock_guard<std::mutex> lock(connection->mutex);
+      ++connection->num_submitted;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.push_back({connection, index, std::move(*problem)});
+    }
+    queue_condition_.notify_one();
+  }
+
+  // the client is done sending, close now if everything is answered, else
+  // the worker sending the last results does
+  {
+    std::lock_guard<std::mutex> lock(connection->mutex);
+    connection->is_reading_done = true;
+    if (connection->num_answered == connection->num_submitted) {
+      ::close(connection->fd);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    --num_readers_;
+  }
+  queue_condition_.notify_all();
+}
+
+void SolveServer::runWorker(CombinedRun &run) {
+  std::vector<Request> batch;
+  // result lines of the batch per connection, sent once it is solved
+  std::map<Connection *, std::pair<std::ostringstream, std::uint64_t>>
+      results;
+
+  for (;;) {
+    batch.clear();
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_condition_.wait(lock,
+                            [this] { return is_stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      // give the batch a moment to fill while problems keep arriving
+      if (queue_.size() < static_cast<std::size_t>(core::kServerBatchSize)) {
+        queue_condition_.wait_for(
+            lock, std::chrono::microseconds(core::kServerBatchDelayMicros),
+            [this] {
+              return is_stopping_ ||
+                     queue_.size() >=
+                         static_cast<std::size_t>(core::kServerBatchSize);
+            });
+      }
+      const std::size_t batch_size = std::min(
+          queue_.size(), static_cast<std::size_t>(core::kServerBatchSize));
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+    // another worker can take what is left
+    queue_condition_.notify_one();
+
+    for (Request &request : batch) {
+      const auto start = std::chrono::steady_clock::now();
+      const core::SolveStatus solve_state =
+          run.solveProblem(std::move(request.problem));
+      const std::uint64_t time_nanos =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count();
+
+      auto &connection_results = results[request.connection.get()];
+      run.writeResult(connection_results.first, request.index, solve_state,
+                      time_nanos);
+      ++connection_results.second;
+    }
+
+    for (const Request &request : batch) {
+      auto connection_results = results.find(request.connection.get());
+      if (connection_results != results.end()) {
+        sendResults(*request.connection, connection_results->second.first.str(),
+                    connection_results->second.second);
+        results.erase(connection_results);
+      }
+    }
+  }
+}
+
+void SolveServer::sendResults(Connection &connection,
+                              const std::string &results,
+                              const std::uint64_t num_results) {
+  std::lock_guard<std::mutex> lock(connection.mutex);
+  // results for a client that went away are dropped but still counted, so
+  // that the connection is closed
+  writeAll(connection.fd, results);
+  connection.num_answered += num_results;
+  if (connection.is_reading_done &&
+      connection.num_answered == connection.num_submitted) {
+    ::close(connection.fd);
+  }
+}
+
+void SolveServer::writeAll(const int fd, const std::string &data) {
+  std::size_t num_written = 0;
+  while (num_written < data.size()) {
+    const ssize_t count = ::send(fd, data.data() + num_written,
+                                 data.size() - num_written, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;
+    }
+    num_written += static_cast<std::size_t>(count);
+  }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../lib/core/consts.hpp"
+#include "../lib/core/types.hpp"
+#include "combined_solver.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Long lived server solving problems sent over a Unix domain socket.
+ * Each connection sends problems in the format of the problem files and gets
+ * back one result line per problem, as written by CombinedRun::runStream(),
+ * in the order they are solved. The connection is closed once the client has
+ * shut down its side and every problem it sent is answered.
+ *
+ * Problems of every connection go into one queue. Workers take up to
+ * kServerBatchSize of them at a time, waiting kServerBatchDelayMicros for a
+ * batch to fill, and answer each connection of a batch with a single write.
+ * Every worker keeps its own CombinedRun, so pipelines and the storage of
+ * their solvers stay warm from one request to the next
+ */
+class SolveServer {
+public:
+  /**
+   * @brief Workers solve like a run with the settings of another
+   *
+   * @param settings run whose settings are copied to every worker
+   * @param num_workers at most kServerMaxWorkers are started
+   */
+  SolveServer(const CombinedRun &settings, const int num_workers);
+
+  /**
+   * @brief Listen on a socket path, replacing a stale socket there, and serve
+   * connections until accepting fails
+   *
+   * @param socket_path
+   * @return bool false if the socket could not be set up
+   */
+  bool run(const std::string &socket_path);
+
+private:
+  // a client connection, written to by the workers answering its problems
+  struct Connection {
+    int fd;
+    std::mutex mutex;
+    std::uint64_t num_submitted;
+    std::uint64_t num_answered;
+    bool is_reading_done;
+  };
+
+  // a problem waiting in the queue, with its index on its connection
+  struct Request {
+    std::shared_ptr<Connection> connection;
+    std::uint64_t index;
+    core::InputRows problem;
+  };
+
+  // reads a socket for the problem reader
+  class SocketBuffer : public std::streambuf {
+  public:
+    explicit SocketBuffer(const int fd);
+
+  protected:
+    int_type underflow() override;
+
+  private:
+    int fd_;
+    char buffer_[1 << 16];
+  };
+
+  std::vector<std::unique_ptr<CombinedRun>> worker_runs_;
+  std::vector<std::thread> workers_;
+
+  std::deque<Request> queue_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_condition_;
+  bool is_stopping_;
+  // connections still being read, each by a thread of its own
+  int num_readers_;
+
+  /**
+   * @brief Queue the problems of a connection as they arrive, closing it
+   * once the client is done and every problem is answered
+   *
+   * @param connection
+   */
+  void readConnection(std::shared_ptr<Connection> connection);
+
+  /**
+   * @brief Solve batches from the queue until the server stops
+   *
+   * @param run
+   */
+  void runWorker(CombinedRun &run);
+
+  /**
+   * @brief Send the results of a connection, counting them as answered
+   *
+   * @param connection
+   * @param results result lines
+   * @param num_results
+   */
+  void sendResults(Connection &connection, const std::string &results,
+                   const std::uint64_t num_results);
+
+  /**
+   * @brief Write all of a buffer to a socket, stopping at the first error,
+   * such as the client having gone away
+   *
+   * @param fd
+   * @param data
+   */
+  static void writeAll(const int fd, const std::string &data);
+};
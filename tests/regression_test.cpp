@@ -0,0 +1,262 @@
+#include "../lib/core/types.hpp"
+#include "../lib/solvers/branch_and_bound/branch_and_bound.hpp"
+#include "../lib/solvers/pipeline/solver_registry.hpp"
+#include "../lib/utils/fused_reformatter.hpp"
+#include "../lib/utils/reader.hpp"
+#include "../lib/utils/results_writer.hpp"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// a pipeline to check, and the fewest verdicts it must give on the 53
+// problems with rows. Pipelines ending in a simplex answer all of them, the
+// other stages only those they take, e.g. tiny those of a few rows and columns
+struct PipelineCheck {
+  const char *pipeline;
+  int min_verdicts;
+};
+
+const PipelineCheck kPipelineChecks[] = {
+    {"presolve", 14},
+    {"fourier_motzkin", 26},
+    {"tiny", 8},
+    {"dual", 53},
+    {"interior_point", 10},
+    {"pdhg", 2},
+    {"primal", 53},
+    {"presolve,fourier_motzkin", 28},
+    {"presolve,tiny", 26},
+    {"presolve,dual", 53},
+    {"presolve,tiny,dual,primal", 53},
+};
+
+// verdicts of a problem with and without integrality, the integer one is
+// left out where branch and bound hits its node limit
+struct ExpectedVerdicts {
+  core::SolveStatus verdict;
+  std::optional<core::SolveStatus> integer_verdict;
+};
+
+// absolute tolerance on a row, scaled by the size of its terms
+const double kRowTolerance = 1e-6;
+
+std::optional<core::SolveStatus> parseVerdict(const std::string &name) {
+  if (name == "feasible") {
+    return core::SolveStatus::kFeasible;
+  }
+  if (name == "infeasible") {
+    return core::SolveStatus::kInfeasible;
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief reads one line per problem, its verdict then its integer verdict,
+ * "none" for an integer verdict not checked
+ *
+ * @param path
+ * @return std::optional<std::vector<ExpectedVerdicts>>
+ */
+std::optional<std::vector<ExpectedVerdicts>>
+readVerdicts(const std::string &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  std::vector<ExpectedVerdicts> verdicts;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string verdict_name;
+    std::string integer_verdict_name;
+    if (!(fields >> verdict_name >> integer_verdict_name)) {
+      continue;
+    }
+    const std::optional<core::SolveStatus> verdict = parseVerdict(verdict_name);
+    if (!verdict) {
+      return std::nullopt;
+    }
+    verdicts.push_back({*verdict, parseVerdict(integer_verdict_name)});
+  }
+  return verdicts;
+}
+
+bool isEmpty(const core::InputRows &problem) {
+  return problem.equality_rows.empty() && problem.inequality_rows.empty();
+}
+
+/**
+ * @brief returns whether values of every variable satisfy the rows
+ *
+ * @param problem
+ * @param values
+ * @return bool
+ */
+bool isSolution(const core::InputRows &problem,
+                const std::vector<double> &values) {
+  if (static_cast<int>(values.size()) != problem.num_variables - 1) {
+    return false;
+  }
+  const auto getViolation = [&values](const std::vector<float> &row,
+                                      const bool is_equality) {
+    double activity = row.at(0);
+    double scale = std::fabs(row.at(0));
+    for (std::size_t j = 0; j < values.size(); ++j) {
+      activity += row.at(j + 1) * values.at(j);
+      scale += std::fabs(row.at(j + 1) * values.at(j));
+    }
+    const double violation =
+        is_equality ? std::fabs(activity) : std::max(-activity, 0.0);
+    return violation / (1 + scale);
+  };
+  for (const std::vector<float> &row : problem.inequality_rows) {
+    if (getViolation(row, false) > kRowTolerance) {
+      return false;
+    }
+  }
+  for (const std::vector<float> &row : problem.equality_rows) {
+    if (getViolation(row, true) > kRowTolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief checks one verdict and the solution given with it, printing what
+ * is wrong
+ *
+ * @param solver name for messages
+ * @param index of the problem
+ * @param problem
+ * @param solve_status returned
+ * @param expected
+ * @param values solution, checked if feasible
+ * @return bool whether the verdict is right
+ */
+bool checkVerdict(const std::string &solver, const std::size_t index,
+                  const core::InputRows &problem,
+                  const core::SolveStatus solve_status,
+                  const core::SolveStatus expected,
+                  const std::vector<double> &values) {
+  if (solve_status != expected) {
+    std::cout << solver << ": problem " << index << " is "
+              << utils::getSolveStatusName(solve_status) << ", expected "
+              << utils::getSolveStatusName(expected) << std::endl;
+    return false;
+  }
+  if (solve_status == core::SolveStatus::kFeasible &&
+      !isSolution(problem, values)) {
+    std::cout << solver << ": problem " << index
+              << " is feasible but its solution violates the rows"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+// Solves every problem of a file with each pipeline above and with branch and
+// bound, checking verdicts against a file of fixed ones and feasible
+// solutions against the rows. Stages may give no verdict, but never a wrong
+// one. Exits with 1 if any check fails
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::cerr << "Usage: regression_test <problem file> <verdict file>"
+              << std::endl;
+    return 1;
+  }
+
+  std::ifstream problem_file(argv[1]);
+  if (!problem_file.is_open()) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+  utils::ModifiedPrimalReader reader(problem_file);
+  std::vector<core::InputRows> problems;
+  while (std::optional<core::InputRows> problem = reader.getNextProblem()) {
+    problems.push_back(std::move(*problem));
+  }
+
+  const std::optional<std::vector<ExpectedVerdicts>> expected =
+      readVerdicts(argv[2]);
+  if (!expected || expected->size() != problems.size()) {
+    std::cerr << "Could not read a verdict for each of the " << problems.size()
+              << " problems from " << argv[2] << std::endl;
+    return 1;
+  }
+
+  bool is_passing = true;
+  const solvers::pipeline::SolverRegistry solver_registry;
+  for (const PipelineCheck &check : kPipelineChecks) {
+    std::optional<solvers::pipeline::SolverPipeline> pipeline =
+        solver_registry.createPipeline(
+            check.pipeline, {core::PricingStrategy::kDantzig, false});
+    if (!pipeline) {
+      std::cout << "Could not build pipeline " << check.pipeline << std::endl;
+      is_passing = false;
+      continue;
+    }
+
+    int num_verdicts = 0;
+    core::PipelineProblem pipeline_problem;
+    for (std::size_t i = 0; i < problems.size(); ++i) {
+      // the runs answer problems without rows before any solver
+      if (isEmpty(problems.at(i))) {
+        continue;
+      }
+      pipeline_problem = core::PipelineProblem();
+      pipeline_problem.rows = problems.at(i);
+      const core::SolveStatus solve_status =
+          pipeline->solveProblem(pipeline_problem);
+      if (solve_status != core::SolveStatus::kFeasible &&
+          solve_status != core::SolveStatus::kInfeasible) {
+        continue;
+      }
+      ++num_verdicts;
+      is_passing &= checkVerdict(check.pipeline, i, problems.at(i),
+                                 solve_status, expected->at(i).verdict,
+                                 pipeline_problem.variable_values);
+    }
+    std::cout << check.pipeline << ": " << num_verdicts << " verdicts"
+              << std::endl;
+    if (num_verdicts < check.min_verdicts) {
+      std::cout << check.pipeline << ": expected at least "
+                << check.min_verdicts << " verdicts" << std::endl;
+      is_passing = false;
+    }
+  }
+
+  int num_integer_verdicts = 0;
+  utils::FusedReformatter rf;
+  solvers::branch_and_bound::BranchAndBound integer_solver;
+  for (std::size_t i = 0; i < problems.size(); ++i) {
+    if (!expected->at(i).integer_verdict || isEmpty(problems.at(i))) {
+      continue;
+    }
+    const core::InputRows &problem = problems.at(i);
+    rf.reformatProblem(problem);
+    integer_solver.setProblem(rf.getLogicalProblem(),
+                              static_cast<int>(problem.inequality_rows.size()),
+                              static_cast<int>(problem.equality_rows.size()));
+    const core::SolveStatus solve_status = integer_solver.solveProblem();
+    const std::vector<int> integer_solution = integer_solver.getSolution();
+    ++num_integer_verdicts;
+    is_passing &= checkVerdict(
+        "branch_and_bound", i, problem, solve_status,
+        *expected->at(i).integer_verdict,
+        std::vector<double>(integer_solution.begin(), integer_solution.end()));
+  }
+  std::cout << "branch_and_bound: " << num_integer_verdicts << " verdicts"
+            << std::endl;
+
+  std::cout << (is_passing ? "Passed" : "Failed") << std::endl;
+  return is_passing ? 0 : 1;
+}